@@ -0,0 +1,219 @@
+#include "batch_renderer.h"
+#include <stdlib.h>
+#include "renderer.h"
+#include "timer.h"
+
+#define VERTICES_PER_QUAD 4
+#define INDICES_PER_QUAD 6
+
+static unsigned char color_channel(float value) {
+  if (value <= 0.0f) return 0;
+  if (value >= 1.0f) return 255;
+  return (unsigned char)(value * 255.0f + 0.5f);
+}
+
+static index_buffer_t create_quad_indices(void) {
+  unsigned int count = BATCH_RENDERER_MAX_QUADS * INDICES_PER_QUAD;
+  unsigned int* indices = (unsigned int*)malloc(count * sizeof(unsigned int));
+
+  for (unsigned int quad = 0; quad < BATCH_RENDERER_MAX_QUADS; quad++) {
+    unsigned int* index = &indices[quad * INDICES_PER_QUAD];
+    unsigned int first = quad * VERTICES_PER_QUAD;
+    index[0] = first;
+    index[1] = first + 1;
+    index[2] = first + 2;
+    index[3] = first + 2;
+    index[4] = first + 3;
+    index[5] = first;
+  }
+
+  index_buffer_t buffer = index_buffer_create(indices, count);
+  free(indices);
+  return buffer;
+}
+
+static unsigned int create_white_texture(void) {
+  unsigned int texture;
+  unsigned char white[4] = {255, 255, 255, 255};
+
+  GLCall(glGenTextures(1, &texture));
+  GLCall(glBindTexture(GL_TEXTURE_2D, texture));
+  GLCall(glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, 1, 1, 0, GL_RGBA,
+                      GL_UNSIGNED_BYTE, white));
+  GLCall(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST));
+  GLCall(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST));
+
+  return texture;
+}
+
+static void reset_batch(batch_renderer_t* batch) {
+  batch->quad_count = 0;
+  batch->textures[0] = batch->white_texture;
+  batch->texture_count = 1;
+}
+
+batch_renderer_t batch_renderer_create(shader_t* shader) {
+  batch_renderer_t batch;
+
+  batch.vertices = (batch_vertex_t*)malloc(
+      BATCH_RENDERER_MAX_QUADS * VERTICES_PER_QUAD * sizeof(batch_vertex_t));
+
+  batch.vertex_buffer = vertex_buffer_create_with_usage(
+      NULL,
+      BATCH_RENDERER_MAX_QUADS * VERTICES_PER_QUAD * sizeof(batch_vertex_t),
+      BUFFER_USAGE_STREAM);
+  batch.index_buffer = create_quad_indices();
+
+  batch.layout = vertex_buffer_layout_create();
+  vertex_buffer_layout_push_float(&batch.layout, 2);  // position
+  vertex_buffer_layout_push_float(&batch.layout, 2);  // tex_coord
+  vertex_buffer_layout_push_uchar(&batch.layout, 4);  // color
+  vertex_buffer_layout_push_float(&batch.layout, 1);  // tex_index
+  vertex_buffer_layout_build(&batch.layout);
+
+  batch.vertex_array = vertex_array_create();
+  vertex_array_add_buffer(&batch.vertex_array, &batch.vertex_buffer,
+                          &batch.layout);
+  index_buffer_bind(&batch.index_buffer);
+
+  batch.white_texture = create_white_texture();
+
+  batch.shader = shader;
+  int slots[BATCH_RENDERER_MAX_TEXTURES];
+  for (int slot = 0; slot < BATCH_RENDERER_MAX_TEXTURES; slot++)
+    slots[slot] = slot;
+  shader_set_int_array(shader, "u_Textures", slots,
+                       BATCH_RENDERER_MAX_TEXTURES);
+
+  batch.frame_start = 0.0;
+  batch.stats = (batch_renderer_stats_t){0};
+  reset_batch(&batch);
+
+  return batch;
+}
+
+void batch_renderer_destroy(batch_renderer_t* batch) {
+  if (batch && batch->vertices) {
+    free(batch->vertices);
+    batch->vertices = NULL;
+    vertex_array_destroy(&batch->vertex_array);
+    vertex_buffer_destroy(&batch->vertex_buffer);
+    index_buffer_destroy(&batch->index_buffer);
+    vertex_buffer_layout_destroy(&batch->layout);
+    GLCall(glDeleteTextures(1, &batch->white_texture));
+  }
+}
+
+void batch_renderer_begin(batch_renderer_t* batch,
+                          const float* view_projection) {
+  batch->stats = (batch_renderer_stats_t){0};
+  batch->frame_start = timer_now();
+
+  shader_set_mat4(batch->shader, "u_ViewProjection", view_projection);
+  reset_batch(batch);
+}
+
+void batch_renderer_flush(batch_renderer_t* batch) {
+  if (batch->quad_count == 0) return;
+
+  vertex_buffer_set_data(
+      &batch->vertex_buffer, batch->vertices,
+      batch->quad_count * VERTICES_PER_QUAD * sizeof(batch_vertex_t));
+
+  for (unsigned int slot = 0; slot < batch->texture_count; slot++) {
+    GLCall(glActiveTexture(GL_TEXTURE0 + slot));
+    GLCall(glBindTexture(GL_TEXTURE_2D, batch->textures[slot]));
+  }
+
+  shader_bind(batch->shader);
+  vertex_array_bind(&batch->vertex_array);
+  index_buffer_bind(&batch->index_buffer);
+  GLCall(glDrawElements(GL_TRIANGLES, batch->quad_count * INDICES_PER_QUAD,
+                        index_buffer_get_type(&batch->index_buffer), NULL));
+
+  batch->stats.draws++;
+  reset_batch(batch);
+}
+
+// Slot of texture in the current batch, flushing first if every slot is
+// taken by other textures
+static float texture_slot(batch_renderer_t* batch, unsigned int texture) {
+  for (unsigned int slot = 0; slot < batch->texture_count; slot++) {
+    if (batch->textures[slot] == texture) return (float)slot;
+  }
+
+  if (batch->texture_count == BATCH_RENDERER_MAX_TEXTURES) {
+    batch_renderer_flush(batch);
+    batch->stats.texture_flushes++;
+  }
+
+  batch->textures[batch->texture_count] = texture;
+  return (float)batch->texture_count++;
+}
+
+static void push_quad(batch_renderer_t* batch, const float* position,
+                      const float* size, float tex_index, const float* uv,
+                      const float* color) {
+  if (batch->quad_count == BATCH_RENDERER_MAX_QUADS) {
+    batch_renderer_flush(batch);
+  }
+
+  // Corners in the index buffer's winding: counter-clockwise from lower left
+  static const float corners[VERTICES_PER_QUAD][2] = {
+      {0.0f, 0.0f}, {1.0f, 0.0f}, {1.0f, 1.0f}, {0.0f, 1.0f}};
+
+  batch_vertex_t* vertex = &batch->vertices[batch->quad_count *
+                                            VERTICES_PER_QUAD];
+  unsigned char packed[4] = {color_channel(color[0]), color_channel(color[1]),
+                             color_channel(color[2]), color_channel(color[3])};
+
+  for (int corner = 0; corner < VERTICES_PER_QUAD; corner++, vertex++) {
+    float x = corners[corner][0], y = corners[corner][1];
+    vertex->position[0] = position[0] + x * size[0];
+    vertex->position[1] = position[1] + y * size[1];
+    vertex->tex_coord[0] = uv[0] + x * (uv[2] - uv[0]);
+    vertex->tex_coord[1] = uv[1] + y * (uv[3] - uv[1]);
+    vertex->color[0] = packed[0];
+    vertex->color[1] = packed[1];
+    vertex->color[2] = packed[2];
+    vertex->color[3] = packed[3];
+    vertex->tex_index = tex_index;
+  }
+
+  batch->quad_count++;
+  batch->stats.quads++;
+}
+
+void batch_renderer_draw_quad(batch_renderer_t* batch, const float* position,
+                              const float* size, const float* color) {
+  static const float full_uv[4] = {0.0f, 0.0f, 1.0f, 1.0f};
+  push_quad(batch, position, size, 0.0f, full_uv, color);
+}
+
+void batch_renderer_draw_textured_quad(batch_renderer_t* batch,
+                                       const float* position,
+                                       const float* size,
+                                       unsigned int texture, const float* uv,
+                                       const float* color) {
+  // Make room first: flushing after the slot is picked would release it
+  if (batch->quad_count == BATCH_RENDERER_MAX_QUADS) {
+    batch_renderer_flush(batch);
+  }
+  float tex_index = texture_slot(batch, texture);
+  push_quad(batch, position, size, tex_index, uv, color);
+}
+
+void batch_renderer_end(batch_renderer_t* batch) {
+  batch_renderer_flush(batch);
+
+  batch->stats.cpu_ms = timer_elapsed_ms(batch->frame_start);
+  batch->stats.quads_per_second =
+      batch->stats.cpu_ms > 0.0
+          ? batch->stats.quads / (batch->stats.cpu_ms / 1000.0)
+          : 0.0;
+}
+
+batch_renderer_stats_t batch_renderer_get_stats(
+    const batch_renderer_t* batch) {
+  return batch->stats;
+}
@@ -0,0 +1,79 @@
+#pragma once
+#include "index_buffer.h"
+#include "shader.h"
+#include "vertex_array.h"
+#include "vertex_buffer.h"
+#include "vertex_buffer_layout.h"
+
+// Quads per draw call. 4 vertices each, so indices still fit in 16 bits.
+#define BATCH_RENDERER_MAX_QUADS 10000
+// Texture units per draw, must match u_Textures in res/shaders/batch.shader
+#define BATCH_RENDERER_MAX_TEXTURES 8
+
+typedef struct batch_vertex {
+  float position[2];
+  float tex_coord[2];
+  unsigned char color[4];
+  float tex_index;
+} batch_vertex_t;
+
+// Counters for the frame between batch_renderer_begin and _end
+typedef struct batch_renderer_stats {
+  unsigned int quads;
+  unsigned int draws;
+  unsigned int texture_flushes;  // Draws forced by running out of slots
+  double cpu_ms;                 // Time spent from begin to end
+  double quads_per_second;       // quads / cpu_ms
+} batch_renderer_stats_t;
+
+// Collects 2D quads into a CPU vertex array and draws them in as few calls
+// as possible: a draw is only issued when the array fills up, when a quad
+// needs a texture beyond the BATCH_RENDERER_MAX_TEXTURES bound this batch,
+// or at batch_renderer_end. The index buffer for the quads is built once.
+typedef struct batch_renderer {
+  batch_vertex_t* vertices;
+  unsigned int quad_count;
+  unsigned int textures[BATCH_RENDERER_MAX_TEXTURES];
+  unsigned int texture_count;
+
+  vertex_buffer_t vertex_buffer;
+  index_buffer_t index_buffer;
+  vertex_buffer_layout_t layout;
+  vertex_array_t vertex_array;
+  unsigned int white_texture;  // Slot 0, used by untextured quads
+
+  shader_t* shader;  // Built from res/shaders/batch.shader, not owned
+
+  double frame_start;
+  batch_renderer_stats_t stats;
+} batch_renderer_t;
+
+// shader must be built from res/shaders/batch.shader and stays owned by the
+// caller
+batch_renderer_t batch_renderer_create(shader_t* shader);
+void batch_renderer_destroy(batch_renderer_t* batch);
+
+// Start a frame. view_projection is a column-major 4x4 matrix.
+void batch_renderer_begin(batch_renderer_t* batch,
+                          const float* view_projection);
+
+// Axis-aligned quad with its lower left corner at position. color is RGBA
+// in [0, 1].
+void batch_renderer_draw_quad(batch_renderer_t* batch, const float* position,
+                              const float* size, const float* color);
+
+// Textured quad. texture is a GL texture name, uv holds u0, v0, u1, v1 and
+// color tints the texels.
+void batch_renderer_draw_textured_quad(batch_renderer_t* batch,
+                                       const float* position,
+                                       const float* size,
+                                       unsigned int texture, const float* uv,
+                                       const float* color);
+
+// Draw everything collected so far
+void batch_renderer_flush(batch_renderer_t* batch);
+
+// Flush and finish the frame's stats
+void batch_renderer_end(batch_renderer_t* batch);
+
+batch_renderer_stats_t batch_renderer_get_stats(const batch_renderer_t* batch);
@@ -0,0 +1,69 @@
+#include "bench.h"
+#include <stdio.h>
+#include <string.h>
+#include "shader.h"
+#include "shader_preprocessor.h"
+
+static const bench_t BENCHES[] = {
+    {"parse", "shader_source_parse on 1 to 64 MB shader files", bench_parse},
+    {"permutations", "shader_permutations of 6 defines, first and second run",
+     bench_permutations},
+    {"file_view", "file_view read against map, cold and warm page cache",
+     bench_file_view},
+    {"stream", "stream_buffer upload MB/s against orphaning and sub data",
+     bench_stream},
+    {"overdraw", "fragments shaded before and after mesh_optimize_overdraw",
+     bench_overdraw},
+    {"vertex_arrays", "draw rate with a vertex array per mesh or per format",
+     bench_vertex_arrays},
+    {"queue", "state changes of a render_queue frame, unsorted and sorted",
+     bench_queue},
+    {"instances", "instance_stream draws from 1k to 1M instances",
+     bench_instances},
+};
+
+#define BENCH_COUNT (sizeof(BENCHES) / sizeof(BENCHES[0]))
+
+bool bench_run(const char* name) {
+  bool all = strcmp(name, "all") == 0;
+  bool found = false;
+
+  for (unsigned int i = 0; i < BENCH_COUNT; i++) {
+    if (!all && strcmp(name, BENCHES[i].name) != 0) continue;
+    printf("== %s: %s\n", BENCHES[i].name, BENCHES[i].description);
+    BENCHES[i].run();
+    found = true;
+  }
+
+  if (!found) {
+    printf("Unknown bench '%s'. Benches:\n", name);
+    for (unsigned int i = 0; i < BENCH_COUNT; i++)
+      printf("  %-14s %s\n", BENCHES[i].name, BENCHES[i].description);
+    printf("  %-14s %s\n", "all", "every bench in turn");
+  }
+  return found;
+}
+
+unsigned int bench_load_program(const char* path) {
+  shader_source_t source = shader_preprocess_load(path, NULL, 0, 0, NULL);
+  unsigned int program =
+      source.stage_count ? shader_create_program(&source) : 0;
+  shader_source_destroy(&source);
+
+  if (!program) printf("Failed to build %s\n", path);
+  return program;
+}
+
+unsigned int bench_random(unsigned int* state) {
+  // xorshift32
+  unsigned int x = *state;
+  x ^= x << 13;
+  x ^= x >> 17;
+  x ^= x << 5;
+  *state = x;
+  return x;
+}
+
+float bench_random_float(unsigned int* state) {
+  return (float)(bench_random(state) >> 8) * (1.0f / 16777216.0f);
+}
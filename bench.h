@@ -0,0 +1,34 @@
+#pragma once
+#include <stdbool.h>
+
+// Benchmarks run with main --bench <name>. They run on the headless
+// context, so results are not paced by a display and are comparable between
+// build agents. Each sets up its own resources on the current context,
+// prints a table and releases everything again.
+typedef struct bench {
+  const char* name;
+  const char* description;
+  void (*run)(void);
+} bench_t;
+
+// One per bench_*.c
+void bench_parse(void);
+void bench_permutations(void);
+void bench_file_view(void);
+void bench_stream(void);
+void bench_overdraw(void);
+void bench_vertex_arrays(void);
+void bench_queue(void);
+void bench_instances(void);
+
+// Run the bench called name, or every bench for "all". Lists the benches
+// and returns false if there is no such bench.
+bool bench_run(const char* name);
+
+// Link the program in a res/shaders file. Returns 0 and logs on failure.
+unsigned int bench_load_program(const char* path);
+
+// Deterministic pseudo-random numbers, so every run draws the same scene.
+// state must start non-zero.
+unsigned int bench_random(unsigned int* state);
+float bench_random_float(unsigned int* state);  // In [0, 1)
@@ -0,0 +1,112 @@
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "bench.h"
+#include "file_view.h"
+#include "timer.h"
+
+#if !defined(_WIN32)
+#include <fcntl.h>
+#include <unistd.h>
+#define BENCH_EVICT 1
+#endif
+
+#define BENCH_FILE "bench_file_view.tmp"
+
+static bool write_file(size_t size) {
+  FILE* file = fopen(BENCH_FILE, "wb");
+  if (!file) return false;
+
+  char block[4096];
+  for (size_t i = 0; i < sizeof(block); i++) block[i] = (char)(i * 7);
+  for (size_t written = 0; written < size; written += sizeof(block)) {
+    size_t count =
+        size - written < sizeof(block) ? size - written : sizeof(block);
+    fwrite(block, 1, count, file);
+  }
+
+  fflush(file);
+#if BENCH_EVICT
+  fsync(fileno(file));  // Dirty pages cannot be dropped
+#endif
+  fclose(file);
+  return true;
+}
+
+// Drop the file from the page cache, so the next open reads the disk
+static void evict(void) {
+#if BENCH_EVICT
+  int fd = open(BENCH_FILE, O_RDONLY);
+  if (fd >= 0) {
+    posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+    close(fd);
+  }
+#endif
+}
+
+// Open, read a byte of every cache line as a parser would, close.
+// Returns ms.
+static double load(size_t min_map_size, unsigned int* checksum) {
+  double start = timer_now();
+  file_view_t view = file_view_open_with_threshold(BENCH_FILE, min_map_size);
+  unsigned int sum = 0;
+  for (size_t i = 0; i < view.size; i += 64) sum += (unsigned char)view.data[i];
+  file_view_close(&view);
+  *checksum = sum;
+  return timer_elapsed_ms(start);
+}
+
+// Average ms of runs loads through the read path and through the map path
+static void measure(bool cold, int runs, double* read_ms, double* map_ms) {
+  unsigned int read_sum = 0, map_sum = 0;
+  *read_ms = 0.0;
+  *map_ms = 0.0;
+  for (int run = 0; run < runs; run++) {
+    if (cold) evict();
+    *read_ms += load(SIZE_MAX, &read_sum);
+    if (cold) evict();
+    *map_ms += load(0, &map_sum);
+  }
+  *read_ms /= runs;
+  *map_ms /= runs;
+  if (read_sum != map_sum) printf("Read and mapped contents differ\n");
+}
+
+// Load time of reading against mapping, with the page cache cold (file
+// evicted with POSIX_FADV_DONTNEED before every open) and warm, for sizes
+// around FILE_VIEW_MIN_MAP_SIZE. The threshold belongs where mapping
+// starts to win warm, the common case for assets loaded repeatedly.
+void bench_file_view(void) {
+  static const size_t sizes[] = {16 << 10,  64 << 10, 128 << 10, 256 << 10,
+                                 512 << 10, 1 << 20,  2 << 20,   4 << 20,
+                                 32 << 20};
+
+#if !BENCH_EVICT
+  printf("No page cache eviction here, cold columns are warm\n");
+#endif
+  printf("%10s %5s | %9s %9s | %9s %9s | %9s %9s\n", "bytes", "open",
+         "read cold", "map cold", "read warm", "map warm", "read MB/s",
+         "map MB/s");
+
+  for (unsigned int i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++) {
+    size_t size = sizes[i];
+    if (!write_file(size)) {
+      printf("Cannot write %s\n", BENCH_FILE);
+      return;
+    }
+
+    int cold_runs = size < (1 << 20) ? 50 : 5;
+    int warm_runs = size < (1 << 20) ? 2000 : 50;
+    double read_cold, map_cold, read_warm, map_warm;
+    measure(true, cold_runs, &read_cold, &map_cold);
+    load(SIZE_MAX, &(unsigned int){0});  // Back into the page cache
+    measure(false, warm_runs, &read_warm, &map_warm);
+
+    printf("%10zu %5s | %9.4f %9.4f | %9.4f %9.4f | %9.0f %9.0f\n", size,
+           size >= FILE_VIEW_MIN_MAP_SIZE ? "map" : "read", read_cold,
+           map_cold, read_warm, map_warm, size / 1e3 / read_warm,
+           size / 1e3 / map_warm);
+  }
+
+  remove(BENCH_FILE);
+}
@@ -0,0 +1,102 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "bench.h"
+#include "index_buffer.h"
+#include "instance_stream.h"
+#include "renderer.h"
+#include "timer.h"
+#include "vertex_array.h"
+#include "vertex_buffer.h"
+#include "vertex_buffer_layout.h"
+
+#define MAX_INSTANCES 1000000
+#define GRID_SIZE 1000  // Instances per row, so 1M fill the target once
+#define FRAMES 5
+
+typedef struct instance {
+  float transform[16];  // Column-major
+  float color[4];
+} instance_t;
+
+// Frame time of instance_stream_draw as the instance count grows tenfold,
+// best of FRAMES frames each. Every frame uploads all instance data again,
+// as a scene with moving objects would.
+void bench_instances(void) {
+  unsigned int program = bench_load_program("res/shaders/instanced.shader");
+  if (!program) return;
+
+  float quad[] = {0.0f, 0.0f, 1.0f, 0.0f, 1.0f, 1.0f, 0.0f, 1.0f};
+  unsigned int indices[] = {0, 1, 2, 2, 3, 0};
+  vertex_buffer_t vb = vertex_buffer_create(quad, sizeof(quad));
+  index_buffer_t ib = index_buffer_create(indices, 6);
+
+  vertex_buffer_layout_t vertex_layout = vertex_buffer_layout_create();
+  vertex_buffer_layout_push_float(&vertex_layout, 2);
+  vertex_buffer_layout_build(&vertex_layout);
+
+  vertex_buffer_layout_t instance_layout = vertex_buffer_layout_create();
+  vertex_buffer_layout_push_mat4(&instance_layout);
+  vertex_buffer_layout_push_float(&instance_layout, 4);
+  vertex_buffer_layout_set_divisor(&instance_layout, 1);
+  vertex_buffer_layout_build(&instance_layout);
+
+  vertex_array_t array = vertex_array_create();
+  vertex_array_set_format(&array, &vertex_layout, 0);
+  vertex_array_set_format(&array, &instance_layout, 1);
+  vertex_array_set_vertex_buffer(&array, 0, &vb, &vertex_layout, 0);
+
+  // A grid of small quads in clip space
+  instance_t* instances =
+      (instance_t*)malloc((size_t)MAX_INSTANCES * sizeof(instance_t));
+  float scale = 2.0f / GRID_SIZE;
+  for (unsigned int i = 0; i < MAX_INSTANCES; i++) {
+    instance_t* instance = &instances[i];
+    memset(instance, 0, sizeof(*instance));
+    instance->transform[0] = scale;
+    instance->transform[5] = scale;
+    instance->transform[10] = 1.0f;
+    instance->transform[12] = (i % GRID_SIZE) * scale - 1.0f;
+    instance->transform[13] = (i / GRID_SIZE % GRID_SIZE) * scale - 1.0f;
+    instance->transform[15] = 1.0f;
+    instance->color[0] = (float)(i % 7) / 6.0f;
+    instance->color[1] = (float)(i % 5) / 4.0f;
+    instance->color[2] = 1.0f;
+    instance->color[3] = 1.0f;
+  }
+
+  instance_stream_t stream =
+      instance_stream_create(MAX_INSTANCES * sizeof(instance_t));
+
+  printf("%10s %10s %12s %6s %8s\n", "instances", "ms/frame", "Minst/s",
+         "draws", "dropped");
+  for (unsigned int count = 1000; count <= MAX_INSTANCES; count *= 10) {
+    double best_ms = 1e9;
+    for (int frame = 0; frame < FRAMES; frame++) {
+      double start = timer_now();
+      instance_stream_begin_frame(&stream);
+      GLCall(glClear(GL_COLOR_BUFFER_BIT));
+      instance_stream_draw(&stream, &array, &ib, program, 1,
+                           &instance_layout, instances, count);
+      instance_stream_end_frame(&stream);
+      GLCall(glFinish());
+
+      double ms = timer_elapsed_ms(start);
+      if (ms < best_ms) best_ms = ms;
+    }
+
+    instance_stream_stats_t stats = instance_stream_get_stats(&stream);
+    printf("%10u %10.3f %12.2f %6u %8u\n", count, best_ms,
+           count / best_ms / 1000.0, stats.draws, stats.dropped);
+  }
+
+  instance_stream_destroy(&stream);
+  free(instances);
+  vertex_array_destroy(&array);
+  vertex_buffer_layout_destroy(&instance_layout);
+  vertex_buffer_layout_destroy(&vertex_layout);
+  index_buffer_destroy(&ib);
+  vertex_buffer_destroy(&vb);
+  renderer_forget_program(program);
+  GLCall(glDeleteProgram(program));
+}
@@ -0,0 +1,169 @@
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "bench.h"
+#include "fragment_query.h"
+#include "index_buffer.h"
+#include "mesh_optimizer.h"
+#include "renderer.h"
+#include "shader.h"
+#include "vertex_array.h"
+#include "vertex_buffer.h"
+#include "vertex_buffer_layout.h"
+
+#define GRID 200  // Quads per side of the parametric mesh
+#define VIEWS 16
+
+// A bumpy sphere: concave folds make triangles cover each other from most
+// directions, so draw order matters
+static float* create_positions(unsigned int* vertex_count) {
+  *vertex_count = (GRID + 1) * (GRID + 1);
+  float* positions = (float*)malloc(*vertex_count * 3 * sizeof(float));
+  for (int y = 0; y <= GRID; y++) {
+    for (int x = 0; x <= GRID; x++) {
+      float theta = 3.14159265f * y / GRID;
+      float phi = 6.28318531f * x / GRID;
+      float radius = 1.0f + 0.35f * sinf(7.0f * theta) * sinf(7.0f * phi);
+      float* p = &positions[(y * (GRID + 1) + x) * 3];
+      p[0] = radius * sinf(theta) * cosf(phi);
+      p[1] = radius * cosf(theta);
+      p[2] = radius * sinf(theta) * sinf(phi);
+    }
+  }
+  return positions;
+}
+
+// Triangles in shuffled order, as an unoptimised exporter might emit them
+static unsigned int* create_indices(unsigned int* index_count) {
+  *index_count = GRID * GRID * 6;
+  unsigned int* indices = (unsigned int*)malloc(*index_count * sizeof(int));
+  unsigned int k = 0;
+  for (unsigned int y = 0; y < GRID; y++) {
+    for (unsigned int x = 0; x < GRID; x++) {
+      unsigned int a = y * (GRID + 1) + x, b = a + 1;
+      unsigned int c = a + GRID + 1, d = c + 1;
+      indices[k++] = a;
+      indices[k++] = b;
+      indices[k++] = c;
+      indices[k++] = c;
+      indices[k++] = b;
+      indices[k++] = d;
+    }
+  }
+
+  unsigned int state = 1;
+  for (unsigned int t = *index_count / 3 - 1; t > 0; t--) {
+    unsigned int r = bench_random(&state) % (t + 1);
+    for (int j = 0; j < 3; j++) {
+      unsigned int swap = indices[t * 3 + j];
+      indices[t * 3 + j] = indices[r * 3 + j];
+      indices[r * 3 + j] = swap;
+    }
+  }
+  return indices;
+}
+
+// Fragments shaded and fragments passing the depth test, summed over VIEWS
+// rotations of the mesh, for the vertex cache order and for
+// mesh_optimize_overdraw at several thresholds. Software rasterisers count
+// shader invocations before the depth test, so there only the samples
+// passed column follows draw order.
+void bench_overdraw(void) {
+  unsigned int program = bench_load_program("res/shaders/overdraw.shader");
+  if (!program) return;
+  shader_t shader = shader_create(program);
+
+  unsigned int vertex_count, index_count;
+  float* positions = create_positions(&vertex_count);
+  unsigned int* shuffled = create_indices(&index_count);
+  unsigned int* cache_order =
+      (unsigned int*)malloc(index_count * sizeof(unsigned int));
+  unsigned int* reordered =
+      (unsigned int*)malloc(index_count * sizeof(unsigned int));
+  mesh_optimize_vertex_cache(cache_order, shuffled, index_count,
+                             vertex_count);
+
+  vertex_buffer_t vb =
+      vertex_buffer_create(positions, vertex_count * 3 * sizeof(float));
+  // Rewritten for every order
+  index_buffer_t ib = index_buffer_create_with_usage(cache_order, index_count,
+                                                     BUFFER_USAGE_DYNAMIC);
+  vertex_buffer_layout_t layout = vertex_buffer_layout_create();
+  vertex_buffer_layout_push_float(&layout, 3);
+  vertex_buffer_layout_build(&layout);
+  vertex_array_t array = vertex_array_create();
+  vertex_array_add_buffer(&array, &vb, &layout);
+
+  fragment_query_t invocations = fragment_query_create();
+  // A second query pinned to samples passed, whatever the first one uses
+  fragment_query_t samples = fragment_query_create();
+  samples.target = GL_SAMPLES_PASSED;
+  samples.exact = false;
+
+  GLCall(glEnable(GL_DEPTH_TEST));
+  GLCall(glEnable(GL_CULL_FACE));
+
+  const float thresholds[] = {0.0f, 1.05f, 1.2f, 2.0f, 3.0f};
+  printf("%-10s %6s %14s %14s\n", "order", "acmr",
+         invocations.exact ? "invocations" : "(no stats)", "samples");
+  for (unsigned int pass = 0; pass < 5; pass++) {
+    const unsigned int* order = cache_order;
+    if (thresholds[pass] > 0.0f) {
+      mesh_optimize_overdraw(reordered, cache_order, index_count, positions,
+                             vertex_count, 3 * sizeof(float),
+                             thresholds[pass]);
+      order = reordered;
+    }
+    index_buffer_set_data(&ib, order, index_count);
+
+    unsigned long long shaded = 0, passed = 0;
+    for (int view = 0; view < VIEWS; view++) {
+      // Rotation about y, scaled into clip space with z flipped so
+      // smaller view depth is nearer
+      float angle = view * 0.39f, c = cosf(angle), s = sinf(angle);
+      float model[16] = {
+          0.4f * c, 0.0f, 0.3f * s,  0.0f,  // Column 0
+          0.0f,     0.4f, 0.0f,      0.0f,  // Column 1
+          0.4f * s, 0.0f, -0.3f * c, 0.0f,  // Column 2
+          0.0f,     0.0f, 0.0f,      1.0f,  // Column 3
+      };
+      shader_set_mat4(&shader, "u_Model", model);
+
+      GLCall(glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT));
+      if (invocations.exact) fragment_query_begin(&invocations);
+      fragment_query_begin(&samples);
+      renderer_draw(&array, &ib, program);
+      fragment_query_end(&samples);
+      if (invocations.exact) {
+        fragment_query_end(&invocations);
+        shaded += fragment_query_result(&invocations);
+      }
+      passed += fragment_query_result(&samples);
+    }
+
+    mesh_cache_stats_t stats = mesh_analyze_vertex_cache(
+        order, index_count, vertex_count, MESH_OPTIMIZER_CACHE_SIZE);
+    char name[16];
+    if (thresholds[pass] > 0.0f) {
+      snprintf(name, sizeof(name), "od %.2f", thresholds[pass]);
+    } else {
+      snprintf(name, sizeof(name), "cache");
+    }
+    printf("%-10s %6.3f %14llu %14llu\n", name, stats.acmr, shaded, passed);
+  }
+
+  GLCall(glDisable(GL_CULL_FACE));
+  GLCall(glDisable(GL_DEPTH_TEST));
+
+  fragment_query_destroy(&samples);
+  fragment_query_destroy(&invocations);
+  vertex_array_destroy(&array);
+  vertex_buffer_layout_destroy(&layout);
+  index_buffer_destroy(&ib);
+  vertex_buffer_destroy(&vb);
+  shader_destroy(&shader);
+  free(reordered);
+  free(cache_order);
+  free(shuffled);
+  free(positions);
+}
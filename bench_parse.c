@@ -0,0 +1,60 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "bench.h"
+#include "shader_source.h"
+#include "timer.h"
+
+#define MAX_SIZE (64u << 20)
+#define LINES_PER_STAGE 2000
+#define RUNS 5
+
+// A generated uber-shader of about size bytes: stages of LINES_PER_STAGE
+// statement lines, alternating vertex and fragment
+static size_t generate(char* text, size_t size) {
+  size_t length = 0;
+  unsigned int line = 0;
+  while (length + 128 < size) {
+    if (line % LINES_PER_STAGE == 0) {
+      length += sprintf(text + length, "#shader %s\n#version 330 core\n",
+                        line / LINES_PER_STAGE % 2 ? "fragment" : "vertex");
+    }
+    length += sprintf(text + length,
+                      "    vec4 v%u = texture(u_Texture, v_TexCoord * %u.0);\n",
+                      line, line % 97);
+    line++;
+  }
+  return length;
+}
+
+// shader_source_parse time and throughput on multi-megabyte files, best of
+// RUNS. The parser is linear, so MB/s should hold steady as size grows.
+void bench_parse(void) {
+  char* text = (char*)malloc(MAX_SIZE);
+
+  printf("%10s %8s %10s %10s\n", "bytes", "stages", "ms", "MB/s");
+  for (size_t size = 1u << 20; size <= MAX_SIZE; size *= 4) {
+    size_t length = generate(text, size);
+    double best_ms = 1e9;
+    unsigned int stages = 0;
+
+    for (int run = 0; run < RUNS; run++) {
+      // The parser takes ownership of its buffer
+      char* buffer = (char*)malloc(length);
+      memcpy(buffer, text, length);
+
+      double start = timer_now();
+      shader_source_t source = shader_source_parse(buffer, length);
+      double ms = timer_elapsed_ms(start);
+
+      stages = source.stage_count;
+      shader_source_destroy(&source);
+      if (ms < best_ms) best_ms = ms;
+    }
+
+    printf("%10zu %8u %10.3f %10.1f\n", length, stages, best_ms,
+           length / 1e3 / best_ms);
+  }
+
+  free(text);
+}
@@ -0,0 +1,81 @@
+#include <stdio.h>
+#include "bench.h"
+#include "program_cache.h"
+#include "shader_permutation.h"
+#include "shader_preprocessor.h"
+#include "shader_source.h"
+#include "timer.h"
+
+#define SHADER_PATH "res/shaders/permutations.shader"
+#define CACHE_DIRECTORY "bench_permutation_cache"
+
+// The shader tests the first four; the last two never appear in it, so
+// they multiply the masks but not the programs
+static const char* const DEFINES[] = {"USE_VERTEX_COLOR", "USE_TEXTURE",
+                                      "USE_FOG",          "USE_WAVE",
+                                      "USE_SHADOWS",      "USE_NORMAL_MAP"};
+#define DEFINE_COUNT (sizeof(DEFINES) / sizeof(DEFINES[0]))
+#define MASK_COUNT (1u << DEFINE_COUNT)
+
+// Delete the binaries an earlier run stored for every program of the set,
+// so the first pass builds from source
+static void evict_programs(const shader_permutations_t* permutations) {
+  program_cache_t cache = program_cache_create(CACHE_DIRECTORY);
+  for (uint32_t mask = 0; mask < MASK_COUNT; mask++) {
+    if (mask & ~permutations->used_defines) continue;
+
+    size_t size = 0;
+    char* expanded = shader_preprocess_defines(
+        permutations->source, permutations->source_size,
+        permutations->defines, permutations->define_count, mask, &size);
+    // shader_source_parse takes ownership of expanded
+    shader_source_t source = shader_source_parse(expanded, size);
+    program_cache_evict(&cache, &source);
+    shader_source_destroy(&source);
+  }
+  program_cache_destroy(&cache);
+}
+
+// Request every mask twice from a new permutation set and program cache
+static void run_pass(const char* name) {
+  program_cache_t cache = program_cache_create(CACHE_DIRECTORY);
+  shader_permutations_t permutations =
+      shader_permutations_create(SHADER_PATH, DEFINES, DEFINE_COUNT);
+
+  unsigned int failed = 0;
+  double start = timer_now();
+  for (int round = 0; round < 2; round++) {
+    for (uint32_t mask = 0; mask < MASK_COUNT; mask++) {
+      if (!shader_permutations_get(&permutations, &cache, mask)) failed++;
+    }
+  }
+  double ms = timer_elapsed_ms(start);
+
+  shader_permutation_stats_t stats = permutations.stats;
+  printf("%-7s %8u %6u %6u %6u %10u %12u %9.1f\n", name, stats.requests,
+         stats.hits, stats.deduplicated, stats.built, cache.stats.hits,
+         cache.stats.misses, ms);
+  if (failed) printf("%u requests returned no program\n", failed);
+
+  shader_permutations_destroy(&permutations);
+  program_cache_destroy(&cache);
+}
+
+// Programs built for every combination of DEFINE_COUNT feature defines.
+// Masks differing only in unused defines share a program, so 64 masks
+// need 16 builds; the second pass fetches those through a new program
+// cache on the same directory, as the next start of the application would,
+// and loads binaries instead of compiling.
+void bench_permutations(void) {
+  shader_permutations_t permutations =
+      shader_permutations_create(SHADER_PATH, DEFINES, DEFINE_COUNT);
+  if (!permutations.source) return;
+  evict_programs(&permutations);
+  shader_permutations_destroy(&permutations);
+
+  printf("%u masks of %u defines\n", MASK_COUNT, (unsigned int)DEFINE_COUNT);
+  printf("%-7s %8s %6s %6s %6s %10s %12s %9s\n", "pass", "requests", "hits",
+         "dedup", "built", "cache hits", "cache misses", "ms");
+  run_pass("first");
+  run_pass("second");
+}
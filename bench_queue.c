@@ -0,0 +1,109 @@
+#include <stdio.h>
+#include "bench.h"
+#include "index_buffer.h"
+#include "render_queue.h"
+#include "renderer.h"
+#include "timer.h"
+#include "vertex_array_cache.h"
+#include "vertex_buffer.h"
+#include "vertex_buffer_layout.h"
+
+#define SHADERS 16
+#define MATERIALS 8
+#define MESHES 32
+#define COMMANDS 20000
+
+// State changes and time for one frame of a synthetic scene submitted in
+// random order, executed unsorted and then sorted by key. Both frames draw
+// the same commands.
+void bench_queue(void) {
+  unsigned int programs[SHADERS];
+  for (int i = 0; i < SHADERS; i++) {
+    programs[i] = bench_load_program("res/shaders/basic.shader");
+    if (!programs[i]) return;
+  }
+
+  vertex_buffer_layout_t layout = vertex_buffer_layout_create();
+  vertex_buffer_layout_push_float(&layout, 2);
+  vertex_buffer_layout_build(&layout);
+
+  // One small triangle per mesh, each in its own buffers
+  float triangle[] = {0.0f, 0.0f, 0.01f, 0.0f, 0.01f, 0.01f};
+  unsigned int indices[] = {0, 1, 2};
+  vertex_buffer_t vbs[MESHES];
+  index_buffer_t ibs[MESHES];
+  vertex_array_cache_t cache = vertex_array_cache_create();
+  vertex_array_t arrays[MESHES];
+  for (int i = 0; i < MESHES; i++) {
+    vbs[i] = vertex_buffer_create(triangle, sizeof(triangle));
+    ibs[i] = index_buffer_create(indices, 3);
+    arrays[i] = vertex_array_cache_get(&cache, &vbs[i], &layout, &ibs[i]);
+  }
+
+  unsigned int textures[MATERIALS];
+  GLCall(glGenTextures(MATERIALS, textures));
+  for (int i = 0; i < MATERIALS; i++) {
+    unsigned char texel[4] = {(unsigned char)(i * 32), 0, 0, 255};
+    GLCall(glBindTexture(GL_TEXTURE_2D, textures[i]));
+    GLCall(glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, 1, 1, 0, GL_RGBA,
+                        GL_UNSIGNED_BYTE, texel));
+  }
+
+  render_queue_t queue = render_queue_create();
+  printf("%u commands, %u shaders, %u materials, %u meshes\n", COMMANDS,
+         SHADERS, MATERIALS, MESHES);
+  printf("%-9s %6s %8s %8s %8s %8s %9s %8s\n", "order", "draws", "shader",
+         "array", "texture", "sort ms", "total ms", "binds");
+
+  for (int sorted = 0; sorted < 2; sorted++) {
+    queue.sort = sorted;
+    unsigned int state = 1;
+    for (int i = 0; i < COMMANDS; i++) {
+      unsigned int shader = bench_random(&state) % SHADERS;
+      unsigned int material = bench_random(&state) % MATERIALS;
+      unsigned int mesh = bench_random(&state) % MESHES;
+      float depth = bench_random_float(&state);
+      bool translucent = bench_random(&state) % 10 == 0;
+
+      render_command_t command;
+      command.key = render_queue_make_key(translucent ? 1 : 0, translucent,
+                                          shader, material, mesh, depth);
+      command.shader = programs[shader];
+      command.vertex_array = arrays[mesh].m_renderer_id;
+      command.index_buffer = ibs[mesh].m_renderer_id;
+      command.index_type = index_buffer_get_type(&ibs[mesh]);
+      command.index_count = 3;
+      command.first_index = 0;
+      command.base_vertex = 0;
+      command.texture = textures[material];
+      render_queue_submit(&queue, &command);
+    }
+
+    GLCall(glFinish());
+    renderer_begin_frame();
+    double start = timer_now();
+    render_queue_execute(&queue);
+    GLCall(glFinish());
+    double ms = timer_elapsed_ms(start);
+
+    render_queue_stats_t stats = render_queue_get_stats(&queue);
+    renderer_stats_t renderer_stats = renderer_get_stats();
+    printf("%-9s %6u %8u %8u %8u %8.2f %9.2f %8u\n",
+           sorted ? "sorted" : "unsorted", stats.draws, stats.shader_changes,
+           stats.vertex_array_changes, stats.texture_changes, stats.sort_ms,
+           ms, renderer_stats.binds_issued);
+  }
+
+  render_queue_destroy(&queue);
+  GLCall(glDeleteTextures(MATERIALS, textures));
+  vertex_array_cache_destroy(&cache);
+  for (int i = 0; i < MESHES; i++) {
+    vertex_buffer_destroy(&vbs[i]);
+    index_buffer_destroy(&ibs[i]);
+  }
+  vertex_buffer_layout_destroy(&layout);
+  for (int i = 0; i < SHADERS; i++) {
+    renderer_forget_program(programs[i]);
+    GLCall(glDeleteProgram(programs[i]));
+  }
+}
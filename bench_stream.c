@@ -0,0 +1,143 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "bench.h"
+#include "gl_ext.h"
+#include "renderer.h"
+#include "stream_buffer.h"
+#include "timer.h"
+#include "vertex_array.h"
+#include "vertex_buffer.h"
+#include "vertex_buffer_layout.h"
+
+#define CHUNK_SIZE (1u << 20)
+#define CHUNKS_PER_FRAME 4
+#define FRAMES 100
+// Vertices each chunk's draw fetches, so the GPU really reads the upload
+#define DRAW_VERTICES 1024
+
+typedef struct stream_bench {
+  unsigned int program;
+  vertex_array_t array;
+  vertex_buffer_layout_t layout;
+  unsigned char* data;  // One chunk of source vertices
+} stream_bench_t;
+
+static void draw_chunk(stream_bench_t* bench, vertex_buffer_t* vb,
+                       unsigned int offset) {
+  vertex_array_set_vertex_buffer(&bench->array, 0, vb, &bench->layout,
+                                 offset);
+  renderer_use_program(bench->program);
+  vertex_array_bind(&bench->array);
+  GLCall(glDrawArrays(GL_POINTS, 0, DRAW_VERTICES));
+}
+
+// Upload through a stream_buffer, persistent or orphaning depending on
+// whether buffer storage is on when it is created. Returns MB/s.
+static double run_stream_buffer(stream_bench_t* bench,
+                                unsigned int* fence_waits) {
+  stream_buffer_t buffer = stream_buffer_create(
+      GL_ARRAY_BUFFER, CHUNK_SIZE * CHUNKS_PER_FRAME, 3);
+
+  // The GL buffer seen as a vertex buffer for binding
+  vertex_buffer_t view;
+  view.m_renderer_id = buffer.m_renderer_id;
+  view.m_size = buffer.region_size * buffer.region_count;
+  view.m_capacity = view.m_size;
+  view.m_usage = BUFFER_USAGE_STREAM;
+
+  GLCall(glFinish());
+  double start = timer_now();
+  for (int frame = 0; frame < FRAMES; frame++) {
+    stream_buffer_begin_frame(&buffer);
+    for (int chunk = 0; chunk < CHUNKS_PER_FRAME; chunk++) {
+      unsigned int offset;
+      void* destination = stream_buffer_alloc(
+          &buffer, CHUNK_SIZE, vertex_buffer_layout_get_stride(&bench->layout),
+          &offset);
+      memcpy(destination, bench->data, CHUNK_SIZE);
+      stream_buffer_flush(&buffer);
+      draw_chunk(bench, &view, offset);
+    }
+    stream_buffer_end_frame(&buffer);
+  }
+  GLCall(glFinish());
+  double ms = timer_elapsed_ms(start);
+
+  *fence_waits = buffer.stats.fence_waits;
+  stream_buffer_destroy(&buffer);
+  return (double)CHUNK_SIZE * CHUNKS_PER_FRAME * FRAMES / 1e3 / ms;
+}
+
+// glBufferSubData into the same storage every frame, leaving the driver to
+// synchronise with draws still reading it. Returns MB/s.
+static double run_sub_data(stream_bench_t* bench) {
+  vertex_buffer_t vb = vertex_buffer_create_with_usage(
+      NULL, CHUNK_SIZE * CHUNKS_PER_FRAME, BUFFER_USAGE_DYNAMIC);
+
+  GLCall(glFinish());
+  double start = timer_now();
+  for (int frame = 0; frame < FRAMES; frame++) {
+    for (int chunk = 0; chunk < CHUNKS_PER_FRAME; chunk++) {
+      unsigned int offset = chunk * CHUNK_SIZE;
+      vertex_buffer_update(&vb, offset, bench->data, CHUNK_SIZE);
+      draw_chunk(bench, &vb, offset);
+    }
+  }
+  GLCall(glFinish());
+  double ms = timer_elapsed_ms(start);
+
+  vertex_buffer_destroy(&vb);
+  return (double)CHUNK_SIZE * CHUNKS_PER_FRAME * FRAMES / 1e3 / ms;
+}
+
+// Upload throughput of stream_buffer with persistent mapping, its orphaning
+// fallback and plain glBufferSubData, each chunk drawn as points with the
+// rasterizer off so the GPU consumes the data without filling pixels
+void bench_stream(void) {
+  stream_bench_t bench;
+  bench.program = bench_load_program("res/shaders/basic.shader");
+  if (!bench.program) return;
+
+  bench.layout = vertex_buffer_layout_create();
+  vertex_buffer_layout_push_float(&bench.layout, 4);
+  vertex_buffer_layout_build(&bench.layout);
+  bench.array = vertex_array_create();
+  vertex_array_set_format(&bench.array, &bench.layout, 0);
+
+  bench.data = (unsigned char*)malloc(CHUNK_SIZE);
+  float* vertices = (float*)bench.data;
+  for (unsigned int i = 0; i < CHUNK_SIZE / sizeof(float); i++)
+    vertices[i] = (float)(i % 4) * 0.25f;
+
+  GLCall(glEnable(GL_RASTERIZER_DISCARD));
+
+  printf("%u MB per frame, %u frames\n",
+         CHUNK_SIZE * CHUNKS_PER_FRAME >> 20, FRAMES);
+  printf("%-12s %10s %12s\n", "path", "MB/s", "fence waits");
+
+  unsigned int fence_waits = 0;
+  bool buffer_storage = gl_ext.buffer_storage;
+  if (buffer_storage) {
+    double rate = run_stream_buffer(&bench, &fence_waits);
+    printf("%-12s %10.1f %12u\n", "persistent", rate, fence_waits);
+  } else {
+    printf("%-12s %10s\n", "persistent", "n/a");
+  }
+
+  // stream_buffer picks its path at creation
+  gl_ext.buffer_storage = false;
+  double rate = run_stream_buffer(&bench, &fence_waits);
+  gl_ext.buffer_storage = buffer_storage;
+  printf("%-12s %10.1f %12s\n", "orphan", rate, "-");
+
+  printf("%-12s %10.1f %12s\n", "sub data", run_sub_data(&bench), "-");
+
+  GLCall(glDisable(GL_RASTERIZER_DISCARD));
+
+  free(bench.data);
+  vertex_array_destroy(&bench.array);
+  vertex_buffer_layout_destroy(&bench.layout);
+  renderer_forget_program(bench.program);
+  GLCall(glDeleteProgram(bench.program));
+}
@@ -0,0 +1,114 @@
+#include <stdio.h>
+#include "bench.h"
+#include "gl_ext.h"
+#include "index_buffer.h"
+#include "renderer.h"
+#include "timer.h"
+#include "vertex_array.h"
+#include "vertex_array_cache.h"
+#include "vertex_buffer.h"
+#include "vertex_buffer_layout.h"
+
+#define MESHES 4000
+#define PASSES 5
+
+typedef enum vertex_array_mode {
+  MODE_PER_MESH,    // A cached vertex array for every mesh
+  MODE_PER_FORMAT,  // One shared vertex array, buffers rebound per mesh
+} vertex_array_mode_t;
+
+// Draw every mesh PASSES times. Returns draws per millisecond.
+static double run(vertex_array_mode_t mode, unsigned int program,
+                  vertex_buffer_t* vbs, index_buffer_t* ibs,
+                  vertex_array_t* mesh_arrays, vertex_array_t* shared,
+                  const vertex_buffer_layout_t* layout) {
+  GLCall(glFinish());
+  renderer_begin_frame();
+  double start = timer_now();
+
+  for (int pass = 0; pass < PASSES; pass++) {
+    for (int i = 0; i < MESHES; i++) {
+      if (mode == MODE_PER_MESH) {
+        renderer_draw(&mesh_arrays[i], &ibs[i], program);
+      } else {
+        vertex_array_set_vertex_buffer(shared, 0, &vbs[i], layout, 0);
+        renderer_draw(shared, &ibs[i], program);
+      }
+    }
+  }
+
+  GLCall(glFinish());
+  return PASSES * MESHES / timer_elapsed_ms(start);
+}
+
+// Draw-call throughput of many small meshes of one format, each with its
+// own buffers: a vertex array per mesh against one per format with only
+// the buffers rebound, through vertex_attrib_binding and through the
+// attribute pointer fallback
+void bench_vertex_arrays(void) {
+  unsigned int program = bench_load_program("res/shaders/basic.shader");
+  if (!program) return;
+
+  vertex_buffer_layout_t layout = vertex_buffer_layout_create();
+  vertex_buffer_layout_push_float(&layout, 2);  // position
+  vertex_buffer_layout_push_uchar(&layout, 4);  // color
+  vertex_buffer_layout_build(&layout);
+
+  // Tiny quads, so fill rate stays out of the measurement
+  static vertex_buffer_t vbs[MESHES];
+  static index_buffer_t ibs[MESHES];
+  static vertex_array_t mesh_arrays[MESHES];
+  struct {
+    float position[2];
+    unsigned char color[4];
+  } quad[4] = {{{0.0f, 0.0f}, {255, 0, 0, 255}},
+               {{0.001f, 0.0f}, {0, 255, 0, 255}},
+               {{0.001f, 0.001f}, {0, 0, 255, 255}},
+               {{0.0f, 0.001f}, {255, 255, 255, 255}}};
+  unsigned int indices[] = {0, 1, 2, 2, 3, 0};
+
+  vertex_array_cache_t cache = vertex_array_cache_create();
+  for (int i = 0; i < MESHES; i++) {
+    vbs[i] = vertex_buffer_create(quad, sizeof(quad));
+    ibs[i] = index_buffer_create(indices, 6);
+    mesh_arrays[i] = vertex_array_cache_get(&cache, &vbs[i], &layout, &ibs[i]);
+  }
+
+  printf("%u meshes x %u passes\n", MESHES, PASSES);
+  printf("%-24s %10s %10s %10s\n", "vertex arrays", "draws/ms", "binds",
+         "elided");
+
+  // Each path runs twice and reports the second, warm run
+  bool attrib_binding = gl_ext.vertex_attrib_binding;
+  for (int path = 0; path < 3; path++) {
+    if (path == 1 && !attrib_binding) continue;
+    vertex_array_mode_t mode = path == 0 ? MODE_PER_MESH : MODE_PER_FORMAT;
+    // set_format and set_vertex_buffer pick their path from the flag
+    gl_ext.vertex_attrib_binding = path == 2 ? false : attrib_binding;
+
+    vertex_array_t shared = vertex_array_create();
+    vertex_array_set_format(&shared, &layout, 0);
+
+    double rate = 0.0;
+    for (int warm = 0; warm < 2; warm++)
+      rate = run(mode, program, vbs, ibs, mesh_arrays, &shared, &layout);
+
+    renderer_stats_t stats = renderer_get_stats();
+    const char* name = path == 0   ? "per mesh"
+                       : path == 1 ? "per format (binding)"
+                                   : "per format (pointers)";
+    printf("%-24s %10.1f %10u %10u\n", name, rate, stats.binds_issued,
+           stats.binds_elided);
+    vertex_array_destroy(&shared);
+  }
+  gl_ext.vertex_attrib_binding = attrib_binding;
+
+  vertex_array_cache_destroy(&cache);
+  for (int i = 0; i < MESHES; i++) {
+    vertex_buffer_destroy(&vbs[i]);
+    index_buffer_destroy(&ibs[i]);
+  }
+  vertex_buffer_layout_destroy(&layout);
+  renderer_forget_program(program);
+  GLCall(glDeleteProgram(program));
+}
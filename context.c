@@ -0,0 +1,266 @@
+#include "context.h"
+#include <glad/glad.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "gl_ext.h"
+#include "hash.h"
+#include "renderer.h"
+
+#if CONTEXT_GLFW
+#define GLFW_INCLUDE_NONE
+#include <GLFW/glfw3.h>
+#endif
+
+#if CONTEXT_EGL
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+#endif
+
+#define HEADLESS_FRAMES 600
+
+context_options_t context_default_options(context_backend_t backend) {
+  context_options_t options;
+
+  options.backend = backend;
+  options.width = 600;
+  options.height = 400;
+  options.title = "Hello World";
+  options.vsync = true;
+#if RENDERER_GL_DEBUG
+  options.debug = true;
+#else
+  options.debug = false;
+#endif
+  options.frames = backend == CONTEXT_BACKEND_HEADLESS ? HEADLESS_FRAMES : 0;
+
+  return options;
+}
+
+static bool load_gl(GLADloadproc load) {
+  if (!gladLoadGLLoader(load)) {
+    fprintf(stderr, "Failed to initialize GLAD\n");
+    return false;
+  }
+  gl_ext_load(load);
+  // Nothing is known about a new context's bindings
+  renderer_invalidate_state();
+  return true;
+}
+
+#if CONTEXT_GLFW
+static bool create_window(context_t* context,
+                          const context_options_t* options) {
+  if (!glfwInit()) {
+    fprintf(stderr, "Failed to initialize GLFW\n");
+    return false;
+  }
+
+  glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
+  glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+  glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+  if (options->debug) glfwWindowHint(GLFW_OPENGL_DEBUG_CONTEXT, GLFW_TRUE);
+
+  GLFWwindow* window = glfwCreateWindow(options->width, options->height,
+                                        options->title, NULL, NULL);
+  if (!window) {
+    fprintf(stderr, "Failed to create GLFW window\n");
+    glfwTerminate();
+    return false;
+  }
+
+  glfwMakeContextCurrent(window);
+  glfwSwapInterval(options->vsync ? 1 : 0);
+  context->window = window;
+
+  if (!load_gl((GLADloadproc)glfwGetProcAddress)) {
+    glfwDestroyWindow(window);
+    glfwTerminate();
+    return false;
+  }
+  return true;
+}
+#endif
+
+#if CONTEXT_EGL
+static bool create_headless(context_t* context,
+                            const context_options_t* options) {
+  // Surfaceless needs no window system at all; fall back to the default
+  // display where the platform extension is missing
+  EGLDisplay display = EGL_NO_DISPLAY;
+  PFNEGLGETPLATFORMDISPLAYEXTPROC get_platform_display =
+      (PFNEGLGETPLATFORMDISPLAYEXTPROC)eglGetProcAddress(
+          "eglGetPlatformDisplayEXT");
+  if (get_platform_display) {
+    display = get_platform_display(EGL_PLATFORM_SURFACELESS_MESA,
+                                   EGL_DEFAULT_DISPLAY, NULL);
+  }
+  if (display == EGL_NO_DISPLAY) display = eglGetDisplay(EGL_DEFAULT_DISPLAY);
+
+  EGLint major, minor;
+  if (display == EGL_NO_DISPLAY || !eglInitialize(display, &major, &minor)) {
+    fprintf(stderr, "Failed to initialize EGL\n");
+    return false;
+  }
+  context->display = display;
+
+  if (!eglBindAPI(EGL_OPENGL_API)) {
+    fprintf(stderr, "EGL has no desktop OpenGL\n");
+    eglTerminate(display);
+    return false;
+  }
+
+  EGLint attributes[] = {EGL_CONTEXT_MAJOR_VERSION,
+                         3,
+                         EGL_CONTEXT_MINOR_VERSION,
+                         3,
+                         EGL_CONTEXT_OPENGL_PROFILE_MASK,
+                         EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT,
+                         EGL_CONTEXT_OPENGL_DEBUG,
+                         options->debug ? EGL_TRUE : EGL_FALSE,
+                         EGL_NONE};
+  // No config needed (EGL_KHR_no_config_context): nothing is presented
+  EGLContext egl_context =
+      eglCreateContext(display, EGL_NO_CONFIG_KHR, EGL_NO_CONTEXT, attributes);
+  if (egl_context == EGL_NO_CONTEXT ||
+      !eglMakeCurrent(display, EGL_NO_SURFACE, EGL_NO_SURFACE, egl_context)) {
+    fprintf(stderr, "Failed to create a surfaceless GL 3.3 context\n");
+    if (egl_context != EGL_NO_CONTEXT) eglDestroyContext(display, egl_context);
+    eglTerminate(display);
+    return false;
+  }
+  context->egl_context = egl_context;
+
+  // From here on context_create cleans up after failures
+  if (!load_gl((GLADloadproc)eglGetProcAddress)) return false;
+
+  // There is no default framebuffer; draw into our own
+  GLCall(glGenRenderbuffers(1, &context->color_buffer));
+  GLCall(glBindRenderbuffer(GL_RENDERBUFFER, context->color_buffer));
+  GLCall(glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, options->width,
+                               options->height));
+  GLCall(glGenRenderbuffers(1, &context->depth_buffer));
+  GLCall(glBindRenderbuffer(GL_RENDERBUFFER, context->depth_buffer));
+  GLCall(glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH24_STENCIL8,
+                               options->width, options->height));
+
+  GLCall(glGenFramebuffers(1, &context->framebuffer));
+  GLCall(glBindFramebuffer(GL_FRAMEBUFFER, context->framebuffer));
+  GLCall(glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0,
+                                   GL_RENDERBUFFER, context->color_buffer));
+  GLCall(glFramebufferRenderbuffer(GL_FRAMEBUFFER,
+                                   GL_DEPTH_STENCIL_ATTACHMENT,
+                                   GL_RENDERBUFFER, context->depth_buffer));
+  GLCall(GLenum status = glCheckFramebufferStatus(GL_FRAMEBUFFER));
+  if (status != GL_FRAMEBUFFER_COMPLETE) {
+    fprintf(stderr, "Headless framebuffer incomplete: 0x%x\n", status);
+    return false;
+  }
+  GLCall(glViewport(0, 0, options->width, options->height));
+  return true;
+}
+#endif
+
+context_t context_create(const context_options_t* options) {
+  context_t context;
+  memset(&context, 0, sizeof(context));
+  context.backend = options->backend;
+  context.width = options->width;
+  context.height = options->height;
+  context.max_frames = options->frames;
+
+  if (options->backend == CONTEXT_BACKEND_WINDOW) {
+#if CONTEXT_GLFW
+    context.created = create_window(&context, options);
+#else
+    fprintf(stderr, "Built without the window backend (CONTEXT_GLFW)\n");
+#endif
+  } else {
+#if CONTEXT_EGL
+    context.created = create_headless(&context, options);
+    if (!context.created && context.egl_context) context_destroy(&context);
+#else
+    fprintf(stderr, "Built without the headless backend (CONTEXT_EGL)\n");
+#endif
+  }
+
+  return context;
+}
+
+void context_destroy(context_t* context) {
+  if (!context) return;
+
+#if CONTEXT_GLFW
+  if (context->window) {
+    glfwDestroyWindow((GLFWwindow*)context->window);
+    glfwTerminate();
+    context->window = NULL;
+  }
+#endif
+
+#if CONTEXT_EGL
+  if (context->egl_context) {
+    if (context->framebuffer) {
+      GLCall(glDeleteFramebuffers(1, &context->framebuffer));
+    }
+    if (context->color_buffer) {
+      GLCall(glDeleteRenderbuffers(1, &context->color_buffer));
+    }
+    if (context->depth_buffer) {
+      GLCall(glDeleteRenderbuffers(1, &context->depth_buffer));
+    }
+    eglMakeCurrent(context->display, EGL_NO_SURFACE, EGL_NO_SURFACE,
+                   EGL_NO_CONTEXT);
+    eglDestroyContext(context->display, context->egl_context);
+    eglTerminate(context->display);
+    context->egl_context = NULL;
+    context->display = NULL;
+  }
+#endif
+
+  context->framebuffer = 0;
+  context->color_buffer = 0;
+  context->depth_buffer = 0;
+  context->created = false;
+}
+
+bool context_should_close(const context_t* context) {
+  if (!context->created || context->closing) return true;
+  if (context->max_frames && context->frame >= context->max_frames)
+    return true;
+
+#if CONTEXT_GLFW
+  if (context->window)
+    return glfwWindowShouldClose((GLFWwindow*)context->window);
+#endif
+  return false;
+}
+
+void context_close(context_t* context) { context->closing = true; }
+
+void context_present(context_t* context) {
+  context->frame++;
+
+#if CONTEXT_GLFW
+  if (context->window) {
+    glfwSwapBuffers((GLFWwindow*)context->window);
+    glfwPollEvents();
+    return;
+  }
+#endif
+
+  GLCall(glFinish());
+}
+
+uint64_t context_checksum(const context_t* context) {
+  size_t size = (size_t)context->width * context->height * 4;
+  unsigned char* pixels = (unsigned char*)malloc(size);
+
+  GLCall(glPixelStorei(GL_PACK_ALIGNMENT, 1));
+  GLCall(glReadPixels(0, 0, context->width, context->height, GL_RGBA,
+                      GL_UNSIGNED_BYTE, pixels));
+  uint64_t hash = hash_bytes(pixels, size, HASH_SEED);
+
+  free(pixels);
+  return hash;
+}
@@ -0,0 +1,74 @@
+#pragma once
+#include <stdbool.h>
+#include <stdint.h>
+
+// Backends compiled in. GLFW links against glfw3; EGL against libEGL and is
+// on by default on Linux, where headless build agents run Mesa (llvmpipe
+// without a GPU). A headless-only build passes -DCONTEXT_GLFW=0.
+#ifndef CONTEXT_GLFW
+#define CONTEXT_GLFW 1
+#endif
+#ifndef CONTEXT_EGL
+#if defined(__linux__)
+#define CONTEXT_EGL 1
+#else
+#define CONTEXT_EGL 0
+#endif
+#endif
+
+typedef enum context_backend {
+  CONTEXT_BACKEND_WINDOW,   // GLFW window, presents with buffer swaps
+  CONTEXT_BACKEND_HEADLESS  // EGL surfaceless, renders into a framebuffer
+} context_backend_t;
+
+typedef struct context_options {
+  context_backend_t backend;
+  int width;
+  int height;
+  const char* title;    // Window title
+  bool vsync;           // Window only; headless frames are never throttled
+  bool debug;           // Ask for a debug context
+  unsigned int frames;  // Headless: frames to run before closing, 0 = run
+                        // until context_close
+} context_options_t;
+
+// A GL 3.3 core context made current on the calling thread with glad and
+// gl_ext loaded. The headless backend draws into an RGBA8 + depth
+// framebuffer object bound as the default target, so the render loop and
+// every draw path run unchanged, and frames are not paced by a display.
+typedef struct context {
+  context_backend_t backend;
+  bool created;  // False if creation failed; the rest is unset
+  int width;
+  int height;
+  unsigned int frame;       // Frames presented so far
+  unsigned int max_frames;  // Headless frame limit, 0 for none
+  bool closing;
+  void* window;   // GLFWwindow
+  void* display;  // EGLDisplay
+  void* egl_context;
+  unsigned int framebuffer;  // Headless render target and its attachments
+  unsigned int color_buffer;
+  unsigned int depth_buffer;
+} context_t;
+
+// Defaults: 600x400 window with vsync, 600 frames headless
+context_options_t context_default_options(context_backend_t backend);
+
+// Create the context and make it current. Logs why on failure.
+context_t context_create(const context_options_t* options);
+void context_destroy(context_t* context);
+
+// Whether the loop should stop: window closed, frame limit reached or
+// context_close called
+bool context_should_close(const context_t* context);
+void context_close(context_t* context);
+
+// End the frame: swap and poll events for a window. Headless waits for
+// the frame to finish (glFinish), so frame times include the GPU work the
+// swap would otherwise hide.
+void context_present(context_t* context);
+
+// Hash of the current colour buffer contents, to check that headless runs
+// render the same image
+uint64_t context_checksum(const context_t* context);
@@ -0,0 +1,157 @@
+#include "file_view.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+static const char EMPTY[1] = {'\0'};
+
+static file_view_t failed_view(const char* path) {
+  fprintf(stderr, "Failed to open file: %s\n", path);
+  file_view_t view = {NULL, 0, NULL, false};
+  return view;
+}
+
+file_view_t file_view_open(const char* path) {
+  return file_view_open_with_threshold(path, FILE_VIEW_MIN_MAP_SIZE);
+}
+
+#if defined(_WIN32)
+file_view_t file_view_open_with_threshold(const char* path,
+                                          size_t min_map_size) {
+  HANDLE file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, NULL,
+                            OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+  if (file == INVALID_HANDLE_VALUE) return failed_view(path);
+
+  LARGE_INTEGER size;
+  if (!GetFileSizeEx(file, &size)) size.QuadPart = 0;
+
+  void* base = NULL;
+  if ((unsigned long long)size.QuadPart >= min_map_size) {
+    HANDLE mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+    if (mapping) {
+      base = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+      // The view keeps the file and mapping alive
+      CloseHandle(mapping);
+    }
+  }
+
+  if (!base) {
+    // Read through the handle already open
+    size_t capacity = size.QuadPart > 0 ? (size_t)size.QuadPart : 1;
+    char* buffer = (char*)malloc(capacity);
+    DWORD read = 0;
+    size_t total = 0;
+    while (total < (size_t)size.QuadPart) {
+      if (!ReadFile(file, buffer + total, (DWORD)(size.QuadPart - total),
+                    &read, NULL)) {
+        free(buffer);
+        CloseHandle(file);
+        return failed_view(path);
+      }
+      if (read == 0) break;
+      total += read;
+    }
+    CloseHandle(file);
+    return file_view_from_buffer(buffer, total);
+  }
+  CloseHandle(file);
+
+  file_view_t view;
+  view.data = (const char*)base;
+  view.size = (size_t)size.QuadPart;
+  view.base = base;
+  view.mapped = true;
+  return view;
+}
+#else
+file_view_t file_view_open_with_threshold(const char* path,
+                                          size_t min_map_size) {
+  int fd = open(path, O_RDONLY | O_CLOEXEC);
+  if (fd < 0) return failed_view(path);
+
+  struct stat info;
+  bool regular = fstat(fd, &info) == 0 && S_ISREG(info.st_mode);
+  size_t size = regular ? (size_t)info.st_size : 0;
+
+  void* base = MAP_FAILED;
+  if (regular && size >= min_map_size)
+    base = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+
+  if (base == MAP_FAILED) {
+    // Read through the descriptor already open. Pipes and /proc files
+    // report no size, so those are read until end of file.
+    size_t capacity = size > 0 ? size : 4096;
+    char* buffer = (char*)malloc(capacity);
+    size_t total = 0;
+    for (;;) {
+      if (total == capacity) {
+        if (size > 0) break;
+        capacity *= 2;
+        buffer = (char*)realloc(buffer, capacity);
+      }
+      ssize_t count = read(fd, buffer + total, capacity - total);
+      if (count == 0) break;
+      if (count < 0) {
+        if (errno == EINTR) continue;
+        free(buffer);
+        close(fd);
+        return failed_view(path);
+      }
+      total += (size_t)count;
+    }
+    close(fd);
+    return file_view_from_buffer(buffer, total);
+  }
+
+  // The mapping keeps the file alive
+  close(fd);
+
+  // Wider read-ahead, and start it now rather than at the first fault
+  madvise(base, size, MADV_SEQUENTIAL);
+  madvise(base, size, MADV_WILLNEED);
+
+  file_view_t view;
+  view.data = (const char*)base;
+  view.size = size;
+  view.base = base;
+  view.mapped = true;
+  return view;
+}
+#endif
+
+file_view_t file_view_from_buffer(char* buffer, size_t size) {
+  file_view_t view;
+  view.data = buffer ? buffer : EMPTY;
+  view.size = buffer ? size : 0;
+  view.base = buffer;
+  view.mapped = false;
+  return view;
+}
+
+void file_view_close(file_view_t* view) {
+  if (view) {
+    if (view->mapped) {
+#if defined(_WIN32)
+      UnmapViewOfFile(view->base);
+#else
+      munmap(view->base, view->size);
+#endif
+    } else {
+      free(view->base);
+    }
+    view->data = NULL;
+    view->size = 0;
+    view->base = NULL;
+    view->mapped = false;
+  }
+}
@@ -0,0 +1,34 @@
+#pragma once
+#include <stdbool.h>
+#include <stddef.h>
+
+// Files smaller than this are read instead of mapped: below it the map,
+// page faults and unmap cost more than copying (see --bench file_view)
+#define FILE_VIEW_MIN_MAP_SIZE (2 * 1024 * 1024)
+
+// Read-only view of a whole file. Large files are memory-mapped, so loaders
+// parse straight out of the page cache without copying into a heap buffer;
+// mappings are advised for sequential access and read-ahead starts at
+// open. Small files, and files that cannot be mapped, are read into a
+// malloc'd buffer instead. Either way data stays valid until close.
+typedef struct file_view {
+  const char* data;  // Not NUL terminated
+  size_t size;
+  void* base;  // Mapping or owned buffer, NULL for empty views
+  bool mapped;
+} file_view_t;
+
+// Open path. On failure logs and returns a view with NULL data.
+file_view_t file_view_open(const char* path);
+
+// As file_view_open, mapping files of at least min_map_size bytes instead
+// of FILE_VIEW_MIN_MAP_SIZE. 0 maps every non-empty file, SIZE_MAX reads
+// them all; for measuring the threshold.
+file_view_t file_view_open_with_threshold(const char* path,
+                                          size_t min_map_size);
+
+// Wrap a malloc'd buffer, which the view takes ownership of
+file_view_t file_view_from_buffer(char* buffer, size_t size);
+
+// Unmap or free the contents
+void file_view_close(file_view_t* view);
@@ -0,0 +1,171 @@
+#include "file_watcher.h"
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include "timer.h"
+
+#if defined(__linux__)
+#include <sys/inotify.h>
+#include <unistd.h>
+#define WATCHER_INOTIFY 1
+#define WATCH_EVENTS (IN_CLOSE_WRITE | IN_MOVED_TO)
+#else
+#define WATCHER_INOTIFY 0
+#endif
+
+#define INITIAL_CAPACITY 4
+
+// Modification time and size, so writes within the same second of a
+// coarse mtime still show up as long as the size changed
+static void file_state(const char* path, long long* modified,
+                       long long* size) {
+  struct stat info;
+  if (stat(path, &info) != 0) {
+    *modified = -1;
+    *size = -1;
+    return;
+  }
+  *modified = (long long)info.st_mtime;
+  *size = (long long)info.st_size;
+}
+
+file_watcher_t file_watcher_create(void) {
+  file_watcher_t watcher;
+
+  watcher.fd = -1;
+#if WATCHER_INOTIFY
+  watcher.fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+#endif
+  watcher.last_poll = timer_now();
+  watcher.watches =
+      (file_watch_t*)malloc(INITIAL_CAPACITY * sizeof(file_watch_t));
+  watcher.watch_count = 0;
+  watcher.watches_capacity = INITIAL_CAPACITY;
+
+  return watcher;
+}
+
+void file_watcher_destroy(file_watcher_t* watcher) {
+  if (watcher) {
+#if WATCHER_INOTIFY
+    // Closing the instance removes its watches
+    if (watcher->fd >= 0) close(watcher->fd);
+#endif
+    for (unsigned int i = 0; i < watcher->watch_count; i++)
+      free(watcher->watches[i].path);
+    free(watcher->watches);
+    watcher->watches = NULL;
+    watcher->watch_count = 0;
+    watcher->watches_capacity = 0;
+    watcher->fd = -1;
+  }
+}
+
+unsigned int file_watcher_add(file_watcher_t* watcher, const char* path) {
+  if (watcher->watch_count >= watcher->watches_capacity) {
+    watcher->watches_capacity *= 2;
+    watcher->watches = (file_watch_t*)realloc(
+        watcher->watches, watcher->watches_capacity * sizeof(file_watch_t));
+  }
+
+  file_watch_t* watch = &watcher->watches[watcher->watch_count];
+  size_t length = strlen(path);
+  watch->path = (char*)malloc(length + 1);
+  memcpy(watch->path, path, length + 1);
+
+  const char* slash = strrchr(watch->path, '/');
+  const char* backslash = strrchr(watch->path, '\\');
+  if (backslash > slash) slash = backslash;
+  watch->name = slash ? slash + 1 : watch->path;
+
+  watch->descriptor = -1;
+  file_state(path, &watch->modified, &watch->size);
+  watch->changed = false;
+
+#if WATCHER_INOTIFY
+  if (watcher->fd >= 0) {
+    // Watch the directory: saving through a rename replaces the file's
+    // inode, which would silently end a watch on the file itself
+    char* directory;
+    if (slash) {
+      size_t directory_length = slash - watch->path;
+      directory = (char*)malloc(directory_length + 1);
+      memcpy(directory, watch->path, directory_length);
+      directory[directory_length] = '\0';
+    } else {
+      directory = (char*)malloc(2);
+      memcpy(directory, ".", 2);
+    }
+    // Returns the existing descriptor if the directory is already watched
+    watch->descriptor = inotify_add_watch(watcher->fd, directory, WATCH_EVENTS);
+    free(directory);
+  }
+#endif
+
+  return watcher->watch_count++;
+}
+
+#if WATCHER_INOTIFY
+static unsigned int read_events(file_watcher_t* watcher) {
+  unsigned int changed = 0;
+  char buffer[4096]
+      __attribute__((aligned(__alignof__(struct inotify_event))));
+
+  for (;;) {
+    ssize_t length = read(watcher->fd, buffer, sizeof(buffer));
+    if (length <= 0) break;  // EAGAIN: nothing more queued
+
+    for (char* p = buffer; p < buffer + length;) {
+      const struct inotify_event* event = (const struct inotify_event*)p;
+      p += sizeof(struct inotify_event) + event->len;
+      if (event->len == 0) continue;
+
+      for (unsigned int i = 0; i < watcher->watch_count; i++) {
+        file_watch_t* watch = &watcher->watches[i];
+        if (watch->descriptor == event->wd &&
+            strcmp(watch->name, event->name) == 0) {
+          if (!watch->changed) changed++;
+          watch->changed = true;
+        }
+      }
+    }
+  }
+  return changed;
+}
+#endif
+
+unsigned int file_watcher_poll(file_watcher_t* watcher) {
+  unsigned int changed = 0;
+
+#if WATCHER_INOTIFY
+  if (watcher->fd >= 0) changed += read_events(watcher);
+#endif
+
+  // Files without an inotify watch fall back to polling
+  if (timer_elapsed_ms(watcher->last_poll) < FILE_WATCHER_POLL_INTERVAL_MS)
+    return changed;
+  watcher->last_poll = timer_now();
+
+  for (unsigned int i = 0; i < watcher->watch_count; i++) {
+    file_watch_t* watch = &watcher->watches[i];
+    if (watch->descriptor >= 0) continue;
+
+    long long modified, size;
+    file_state(watch->path, &modified, &size);
+    if (modified != watch->modified || size != watch->size) {
+      watch->modified = modified;
+      watch->size = size;
+      if (!watch->changed) changed++;
+      watch->changed = true;
+    }
+  }
+  return changed;
+}
+
+bool file_watcher_changed(file_watcher_t* watcher, unsigned int id) {
+  if (id >= watcher->watch_count || !watcher->watches[id].changed)
+    return false;
+
+  watcher->watches[id].changed = false;
+  return true;
+}
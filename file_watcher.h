@@ -0,0 +1,40 @@
+#pragma once
+#include <stdbool.h>
+
+// How often files are stat'ed when inotify is not available
+#define FILE_WATCHER_POLL_INTERVAL_MS 100.0
+
+typedef struct file_watch {
+  char* path;
+  const char* name;    // File name part of path
+  int descriptor;      // inotify watch on the directory, -1 if none
+  long long modified;  // Last seen modification time and size (polling)
+  long long size;
+  bool changed;
+} file_watch_t;
+
+// Reports files that were written. On Linux it watches their directories
+// with a non-blocking inotify descriptor, catching both in-place writes and
+// editors that save by renaming a new file over the old one. Elsewhere it
+// compares modification times every FILE_WATCHER_POLL_INTERVAL_MS.
+// file_watcher_poll never blocks, so it can run every frame.
+typedef struct file_watcher {
+  int fd;  // inotify instance, -1 when polling
+  double last_poll;
+  file_watch_t* watches;
+  unsigned int watch_count;
+  unsigned int watches_capacity;
+} file_watcher_t;
+
+file_watcher_t file_watcher_create(void);
+void file_watcher_destroy(file_watcher_t* watcher);
+
+// Start watching path. Returns an id for file_watcher_changed.
+unsigned int file_watcher_add(file_watcher_t* watcher, const char* path);
+
+// Collect changes since the last poll. Returns how many watched files
+// changed.
+unsigned int file_watcher_poll(file_watcher_t* watcher);
+
+// Whether the file changed since this was last asked; clears the flag
+bool file_watcher_changed(file_watcher_t* watcher, unsigned int id);
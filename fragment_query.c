@@ -0,0 +1,36 @@
+#include "fragment_query.h"
+#include "gl_ext.h"
+#include "renderer.h"
+
+fragment_query_t fragment_query_create(void) {
+  fragment_query_t query;
+
+  query.exact = gl_ext.pipeline_statistics_query;
+  query.target =
+      query.exact ? GL_FRAGMENT_SHADER_INVOCATIONS : GL_SAMPLES_PASSED;
+  GLCall(glGenQueries(1, &query.m_renderer_id));
+
+  return query;
+}
+
+void fragment_query_destroy(fragment_query_t* query) {
+  if (query && query->m_renderer_id) {
+    GLCall(glDeleteQueries(1, &query->m_renderer_id));
+    query->m_renderer_id = 0;
+  }
+}
+
+void fragment_query_begin(const fragment_query_t* query) {
+  GLCall(glBeginQuery(query->target, query->m_renderer_id));
+}
+
+void fragment_query_end(const fragment_query_t* query) {
+  GLCall(glEndQuery(query->target));
+}
+
+unsigned long long fragment_query_result(const fragment_query_t* query) {
+  GLuint64 result = 0;
+  GLCall(glGetQueryObjectui64v(query->m_renderer_id, GL_QUERY_RESULT,
+                               &result));
+  return result;
+}
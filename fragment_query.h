@@ -0,0 +1,25 @@
+#pragma once
+#include <stdbool.h>
+
+// Counts the fragments shaded between begin and end, to measure overdraw
+// (e.g. before and after mesh_optimize_overdraw) without a profiler. Uses
+// GL_FRAGMENT_SHADER_INVOCATIONS when pipeline statistics are available;
+// otherwise falls back to GL_SAMPLES_PASSED, which with depth testing on
+// counts fragments that passed it, i.e. the ones early-z could not reject.
+// Software rasterisers may count invocations before the depth test; there
+// only the samples-passed count reflects draw order.
+typedef struct fragment_query {
+  unsigned int m_renderer_id;
+  unsigned int target;
+  bool exact;  // True when counting fragment shader invocations
+} fragment_query_t;
+
+fragment_query_t fragment_query_create(void);
+void fragment_query_destroy(fragment_query_t* query);
+
+// Only one query per target can be active at a time
+void fragment_query_begin(const fragment_query_t* query);
+void fragment_query_end(const fragment_query_t* query);
+
+// Waits for the GPU to finish the measured draws
+unsigned long long fragment_query_result(const fragment_query_t* query);
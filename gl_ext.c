@@ -0,0 +1,173 @@
+#include "gl_ext.h"
+#include <string.h>
+
+gl_ext_t gl_ext;
+
+PFNGLGETPROGRAMBINARYPROC gl_ext_glGetProgramBinary = NULL;
+PFNGLPROGRAMBINARYPROC gl_ext_glProgramBinary = NULL;
+PFNGLPROGRAMPARAMETERIPROC gl_ext_glProgramParameteri = NULL;
+PFNGLMAXSHADERCOMPILERTHREADSKHRPROC gl_ext_glMaxShaderCompilerThreadsKHR =
+    NULL;
+PFNGLDEBUGMESSAGECALLBACKPROC gl_ext_glDebugMessageCallback = NULL;
+PFNGLDEBUGMESSAGECONTROLPROC gl_ext_glDebugMessageControl = NULL;
+PFNGLBUFFERSTORAGEPROC gl_ext_glBufferStorage = NULL;
+PFNGLVERTEXATTRIBFORMATPROC gl_ext_glVertexAttribFormat = NULL;
+PFNGLVERTEXATTRIBIFORMATPROC gl_ext_glVertexAttribIFormat = NULL;
+PFNGLVERTEXATTRIBBINDINGPROC gl_ext_glVertexAttribBinding = NULL;
+PFNGLBINDVERTEXBUFFERPROC gl_ext_glBindVertexBuffer = NULL;
+PFNGLVERTEXBINDINGDIVISORPROC gl_ext_glVertexBindingDivisor = NULL;
+PFNGLDRAWARRAYSINSTANCEDBASEINSTANCEPROC
+    gl_ext_glDrawArraysInstancedBaseInstance = NULL;
+PFNGLDRAWELEMENTSINSTANCEDBASEINSTANCEPROC
+    gl_ext_glDrawElementsInstancedBaseInstance = NULL;
+PFNGLDRAWELEMENTSINSTANCEDBASEVERTEXBASEINSTANCEPROC
+    gl_ext_glDrawElementsInstancedBaseVertexBaseInstance = NULL;
+PFNGLMULTIDRAWELEMENTSINDIRECTPROC gl_ext_glMultiDrawElementsIndirect = NULL;
+
+static int gl_version(void) {
+  GLint major = 0, minor = 0;
+  glGetIntegerv(GL_MAJOR_VERSION, &major);
+  glGetIntegerv(GL_MINOR_VERSION, &minor);
+  return major * 10 + minor;
+}
+
+bool gl_ext_has_extension(const char* name) {
+  GLint count = 0;
+  glGetIntegerv(GL_NUM_EXTENSIONS, &count);
+  for (GLint i = 0; i < count; i++) {
+    const char* extension = (const char*)glGetStringi(GL_EXTENSIONS, i);
+    if (extension && strcmp(extension, name) == 0) return true;
+  }
+  return false;
+}
+
+static void load_program_binary(GLADloadproc load, int version) {
+  if (version < 41 && !gl_ext_has_extension("GL_ARB_get_program_binary"))
+    return;
+
+  gl_ext_glGetProgramBinary = (PFNGLGETPROGRAMBINARYPROC)load(
+      "glGetProgramBinary");
+  gl_ext_glProgramBinary = (PFNGLPROGRAMBINARYPROC)load("glProgramBinary");
+  gl_ext_glProgramParameteri = (PFNGLPROGRAMPARAMETERIPROC)load(
+      "glProgramParameteri");
+
+  // Drivers may expose the API with zero formats, which means no caching
+  GLint formats = 0;
+  glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formats);
+
+  gl_ext.program_binary = gl_ext_glGetProgramBinary &&
+                          gl_ext_glProgramBinary &&
+                          gl_ext_glProgramParameteri && formats > 0;
+}
+
+static void load_parallel_shader_compile(GLADloadproc load) {
+  if (gl_ext_has_extension("GL_KHR_parallel_shader_compile")) {
+    gl_ext_glMaxShaderCompilerThreadsKHR =
+        (PFNGLMAXSHADERCOMPILERTHREADSKHRPROC)load(
+            "glMaxShaderCompilerThreadsKHR");
+  } else if (gl_ext_has_extension("GL_ARB_parallel_shader_compile")) {
+    gl_ext_glMaxShaderCompilerThreadsKHR =
+        (PFNGLMAXSHADERCOMPILERTHREADSKHRPROC)load(
+            "glMaxShaderCompilerThreadsARB");
+  }
+
+  if (gl_ext_glMaxShaderCompilerThreadsKHR) {
+    // Let the driver pick as many compiler threads as it wants
+    gl_ext_glMaxShaderCompilerThreadsKHR(0xFFFFFFFFu);
+    gl_ext.parallel_shader_compile = true;
+  }
+}
+
+static void load_debug_output(GLADloadproc load, int version) {
+  if (version >= 43 || gl_ext_has_extension("GL_KHR_debug")) {
+    gl_ext_glDebugMessageCallback =
+        (PFNGLDEBUGMESSAGECALLBACKPROC)load("glDebugMessageCallback");
+    gl_ext_glDebugMessageControl =
+        (PFNGLDEBUGMESSAGECONTROLPROC)load("glDebugMessageControl");
+  } else if (gl_ext_has_extension("GL_ARB_debug_output")) {
+    // Same signatures and enums, only suffixed
+    gl_ext_glDebugMessageCallback =
+        (PFNGLDEBUGMESSAGECALLBACKPROC)load("glDebugMessageCallbackARB");
+    gl_ext_glDebugMessageControl =
+        (PFNGLDEBUGMESSAGECONTROLPROC)load("glDebugMessageControlARB");
+  }
+
+  gl_ext.debug_output =
+      gl_ext_glDebugMessageCallback && gl_ext_glDebugMessageControl;
+}
+
+static void load_buffer_storage(GLADloadproc load, int version) {
+  if (version < 44 && !gl_ext_has_extension("GL_ARB_buffer_storage")) return;
+
+  gl_ext_glBufferStorage = (PFNGLBUFFERSTORAGEPROC)load("glBufferStorage");
+  gl_ext.buffer_storage = gl_ext_glBufferStorage != NULL;
+}
+
+static void load_pipeline_statistics_query(int version) {
+  gl_ext.pipeline_statistics_query =
+      version >= 46 ||
+      gl_ext_has_extension("GL_ARB_pipeline_statistics_query");
+}
+
+static void load_vertex_attrib_binding(GLADloadproc load, int version) {
+  if (version < 43 && !gl_ext_has_extension("GL_ARB_vertex_attrib_binding"))
+    return;
+
+  gl_ext_glVertexAttribFormat =
+      (PFNGLVERTEXATTRIBFORMATPROC)load("glVertexAttribFormat");
+  gl_ext_glVertexAttribIFormat =
+      (PFNGLVERTEXATTRIBIFORMATPROC)load("glVertexAttribIFormat");
+  gl_ext_glVertexAttribBinding =
+      (PFNGLVERTEXATTRIBBINDINGPROC)load("glVertexAttribBinding");
+  gl_ext_glBindVertexBuffer =
+      (PFNGLBINDVERTEXBUFFERPROC)load("glBindVertexBuffer");
+  gl_ext_glVertexBindingDivisor =
+      (PFNGLVERTEXBINDINGDIVISORPROC)load("glVertexBindingDivisor");
+
+  gl_ext.vertex_attrib_binding =
+      gl_ext_glVertexAttribFormat && gl_ext_glVertexAttribIFormat &&
+      gl_ext_glVertexAttribBinding && gl_ext_glBindVertexBuffer &&
+      gl_ext_glVertexBindingDivisor;
+}
+
+static void load_base_instance(GLADloadproc load, int version) {
+  if (version < 42 && !gl_ext_has_extension("GL_ARB_base_instance")) return;
+
+  gl_ext_glDrawArraysInstancedBaseInstance =
+      (PFNGLDRAWARRAYSINSTANCEDBASEINSTANCEPROC)load(
+          "glDrawArraysInstancedBaseInstance");
+  gl_ext_glDrawElementsInstancedBaseInstance =
+      (PFNGLDRAWELEMENTSINSTANCEDBASEINSTANCEPROC)load(
+          "glDrawElementsInstancedBaseInstance");
+  gl_ext_glDrawElementsInstancedBaseVertexBaseInstance =
+      (PFNGLDRAWELEMENTSINSTANCEDBASEVERTEXBASEINSTANCEPROC)load(
+          "glDrawElementsInstancedBaseVertexBaseInstance");
+
+  gl_ext.base_instance =
+      gl_ext_glDrawArraysInstancedBaseInstance &&
+      gl_ext_glDrawElementsInstancedBaseInstance &&
+      gl_ext_glDrawElementsInstancedBaseVertexBaseInstance;
+}
+
+static void load_multi_draw_indirect(GLADloadproc load, int version) {
+  if (version < 43 && !gl_ext_has_extension("GL_ARB_multi_draw_indirect"))
+    return;
+
+  gl_ext_glMultiDrawElementsIndirect =
+      (PFNGLMULTIDRAWELEMENTSINDIRECTPROC)load("glMultiDrawElementsIndirect");
+  gl_ext.multi_draw_indirect = gl_ext_glMultiDrawElementsIndirect != NULL;
+}
+
+void gl_ext_load(GLADloadproc load) {
+  memset(&gl_ext, 0, sizeof(gl_ext));
+
+  int version = gl_version();
+  load_program_binary(load, version);
+  load_parallel_shader_compile(load);
+  load_debug_output(load, version);
+  load_buffer_storage(load, version);
+  load_pipeline_statistics_query(version);
+  load_vertex_attrib_binding(load, version);
+  load_base_instance(load, version);
+  load_multi_draw_indirect(load, version);
+}
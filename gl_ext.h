@@ -0,0 +1,185 @@
+#pragma once
+#include <glad/glad.h>
+#include <stdbool.h>
+
+// glad is generated for the plain GL 3.3 core profile. Newer entry points we
+// can take advantage of are loaded here at runtime, and each feature flag is
+// only set when the context provides it (by core version or by extension).
+
+typedef struct gl_ext {
+  bool program_binary;             // GL 4.1 / ARB_get_program_binary
+  bool parallel_shader_compile;    // KHR/ARB_parallel_shader_compile
+  bool debug_output;               // GL 4.3 / KHR_debug / ARB_debug_output
+  bool buffer_storage;             // GL 4.4 / ARB_buffer_storage
+  bool pipeline_statistics_query;  // GL 4.6 / ARB_pipeline_statistics_query
+  bool vertex_attrib_binding;      // GL 4.3 / ARB_vertex_attrib_binding
+  bool base_instance;              // GL 4.2 / ARB_base_instance
+  bool multi_draw_indirect;        // GL 4.3 / ARB_multi_draw_indirect
+} gl_ext_t;
+
+extern gl_ext_t gl_ext;
+
+// Query the current context and load the entry points it supports. Call once
+// after gladLoadGLLoader with the same loader.
+void gl_ext_load(GLADloadproc load);
+
+// Whether the current context advertises the named extension
+bool gl_ext_has_extension(const char* name);
+
+// GL 4.1 / ARB_get_program_binary
+#ifndef GL_PROGRAM_BINARY_RETRIEVABLE_HINT
+#define GL_PROGRAM_BINARY_RETRIEVABLE_HINT 0x8257
+#define GL_PROGRAM_BINARY_LENGTH 0x8741
+#define GL_NUM_PROGRAM_BINARY_FORMATS 0x87FE
+#define GL_PROGRAM_BINARY_FORMATS 0x87FF
+#endif
+typedef void(APIENTRYP PFNGLGETPROGRAMBINARYPROC)(GLuint program,
+                                                  GLsizei bufSize,
+                                                  GLsizei* length,
+                                                  GLenum* binaryFormat,
+                                                  void* binary);
+typedef void(APIENTRYP PFNGLPROGRAMBINARYPROC)(GLuint program,
+                                               GLenum binaryFormat,
+                                               const void* binary,
+                                               GLsizei length);
+typedef void(APIENTRYP PFNGLPROGRAMPARAMETERIPROC)(GLuint program,
+                                                   GLenum pname, GLint value);
+extern PFNGLGETPROGRAMBINARYPROC gl_ext_glGetProgramBinary;
+extern PFNGLPROGRAMBINARYPROC gl_ext_glProgramBinary;
+extern PFNGLPROGRAMPARAMETERIPROC gl_ext_glProgramParameteri;
+#define glGetProgramBinary gl_ext_glGetProgramBinary
+#define glProgramBinary gl_ext_glProgramBinary
+#define glProgramParameteri gl_ext_glProgramParameteri
+
+// KHR_parallel_shader_compile (ARB variant shares the enums)
+#ifndef GL_COMPLETION_STATUS_KHR
+#define GL_MAX_SHADER_COMPILER_THREADS_KHR 0x91B0
+#define GL_COMPLETION_STATUS_KHR 0x91B1
+#endif
+typedef void(APIENTRYP PFNGLMAXSHADERCOMPILERTHREADSKHRPROC)(GLuint count);
+extern PFNGLMAXSHADERCOMPILERTHREADSKHRPROC
+    gl_ext_glMaxShaderCompilerThreadsKHR;
+#define glMaxShaderCompilerThreadsKHR gl_ext_glMaxShaderCompilerThreadsKHR
+
+// GL 4.3 / KHR_debug
+#ifndef GL_DEBUG_OUTPUT
+#define GL_CONTEXT_FLAG_DEBUG_BIT 0x00000002
+#define GL_DEBUG_OUTPUT 0x92E0
+#define GL_DEBUG_OUTPUT_SYNCHRONOUS 0x8242
+#define GL_DEBUG_SOURCE_API 0x8246
+#define GL_DEBUG_SOURCE_WINDOW_SYSTEM 0x8247
+#define GL_DEBUG_SOURCE_SHADER_COMPILER 0x8248
+#define GL_DEBUG_SOURCE_THIRD_PARTY 0x8249
+#define GL_DEBUG_SOURCE_APPLICATION 0x824A
+#define GL_DEBUG_SOURCE_OTHER 0x824B
+#define GL_DEBUG_TYPE_ERROR 0x824C
+#define GL_DEBUG_TYPE_DEPRECATED_BEHAVIOR 0x824D
+#define GL_DEBUG_TYPE_UNDEFINED_BEHAVIOR 0x824E
+#define GL_DEBUG_TYPE_PORTABILITY 0x824F
+#define GL_DEBUG_TYPE_PERFORMANCE 0x8250
+#define GL_DEBUG_TYPE_OTHER 0x8251
+#define GL_DEBUG_TYPE_MARKER 0x8268
+#define GL_DEBUG_TYPE_PUSH_GROUP 0x8269
+#define GL_DEBUG_TYPE_POP_GROUP 0x826A
+#define GL_DEBUG_SEVERITY_NOTIFICATION 0x826B
+#define GL_DEBUG_SEVERITY_HIGH 0x9146
+#define GL_DEBUG_SEVERITY_MEDIUM 0x9147
+#define GL_DEBUG_SEVERITY_LOW 0x9148
+#endif
+typedef void(APIENTRYP PFNGLDEBUGMESSAGECALLBACKPROC)(GLDEBUGPROC callback,
+                                                      const void* userParam);
+typedef void(APIENTRYP PFNGLDEBUGMESSAGECONTROLPROC)(GLenum source,
+                                                     GLenum type,
+                                                     GLenum severity,
+                                                     GLsizei count,
+                                                     const GLuint* ids,
+                                                     GLboolean enabled);
+extern PFNGLDEBUGMESSAGECALLBACKPROC gl_ext_glDebugMessageCallback;
+extern PFNGLDEBUGMESSAGECONTROLPROC gl_ext_glDebugMessageControl;
+#define glDebugMessageCallback gl_ext_glDebugMessageCallback
+#define glDebugMessageControl gl_ext_glDebugMessageControl
+
+// GL 4.4 / ARB_buffer_storage
+#ifndef GL_MAP_PERSISTENT_BIT
+#define GL_MAP_PERSISTENT_BIT 0x0040
+#define GL_MAP_COHERENT_BIT 0x0080
+#define GL_DYNAMIC_STORAGE_BIT 0x0100
+#define GL_CLIENT_STORAGE_BIT 0x0200
+#endif
+typedef void(APIENTRYP PFNGLBUFFERSTORAGEPROC)(GLenum target, GLsizeiptr size,
+                                               const void* data,
+                                               GLbitfield flags);
+extern PFNGLBUFFERSTORAGEPROC gl_ext_glBufferStorage;
+#define glBufferStorage gl_ext_glBufferStorage
+
+// GL 4.6 / ARB_pipeline_statistics_query: only new query targets, used with
+// the core glBeginQuery / glGetQueryObject*
+#ifndef GL_FRAGMENT_SHADER_INVOCATIONS
+#define GL_VERTICES_SUBMITTED 0x82EE
+#define GL_PRIMITIVES_SUBMITTED 0x82EF
+#define GL_VERTEX_SHADER_INVOCATIONS 0x82F0
+#define GL_CLIPPING_INPUT_PRIMITIVES 0x82F6
+#define GL_CLIPPING_OUTPUT_PRIMITIVES 0x82F7
+#define GL_FRAGMENT_SHADER_INVOCATIONS 0x82F4
+#endif
+
+// GL 4.3 / ARB_vertex_attrib_binding
+typedef void(APIENTRYP PFNGLVERTEXATTRIBFORMATPROC)(GLuint attribindex,
+                                                    GLint size, GLenum type,
+                                                    GLboolean normalized,
+                                                    GLuint relativeoffset);
+typedef void(APIENTRYP PFNGLVERTEXATTRIBIFORMATPROC)(GLuint attribindex,
+                                                     GLint size, GLenum type,
+                                                     GLuint relativeoffset);
+typedef void(APIENTRYP PFNGLVERTEXATTRIBBINDINGPROC)(GLuint attribindex,
+                                                     GLuint bindingindex);
+typedef void(APIENTRYP PFNGLBINDVERTEXBUFFERPROC)(GLuint bindingindex,
+                                                  GLuint buffer,
+                                                  GLintptr offset,
+                                                  GLsizei stride);
+typedef void(APIENTRYP PFNGLVERTEXBINDINGDIVISORPROC)(GLuint bindingindex,
+                                                      GLuint divisor);
+extern PFNGLVERTEXATTRIBFORMATPROC gl_ext_glVertexAttribFormat;
+extern PFNGLVERTEXATTRIBIFORMATPROC gl_ext_glVertexAttribIFormat;
+extern PFNGLVERTEXATTRIBBINDINGPROC gl_ext_glVertexAttribBinding;
+extern PFNGLBINDVERTEXBUFFERPROC gl_ext_glBindVertexBuffer;
+extern PFNGLVERTEXBINDINGDIVISORPROC gl_ext_glVertexBindingDivisor;
+#define glVertexAttribFormat gl_ext_glVertexAttribFormat
+#define glVertexAttribIFormat gl_ext_glVertexAttribIFormat
+#define glVertexAttribBinding gl_ext_glVertexAttribBinding
+#define glBindVertexBuffer gl_ext_glBindVertexBuffer
+#define glVertexBindingDivisor gl_ext_glVertexBindingDivisor
+
+// GL 4.2 / ARB_base_instance
+typedef void(APIENTRYP PFNGLDRAWARRAYSINSTANCEDBASEINSTANCEPROC)(
+    GLenum mode, GLint first, GLsizei count, GLsizei instancecount,
+    GLuint baseinstance);
+typedef void(APIENTRYP PFNGLDRAWELEMENTSINSTANCEDBASEINSTANCEPROC)(
+    GLenum mode, GLsizei count, GLenum type, const void* indices,
+    GLsizei instancecount, GLuint baseinstance);
+typedef void(APIENTRYP PFNGLDRAWELEMENTSINSTANCEDBASEVERTEXBASEINSTANCEPROC)(
+    GLenum mode, GLsizei count, GLenum type, const void* indices,
+    GLsizei instancecount, GLint basevertex, GLuint baseinstance);
+extern PFNGLDRAWARRAYSINSTANCEDBASEINSTANCEPROC
+    gl_ext_glDrawArraysInstancedBaseInstance;
+extern PFNGLDRAWELEMENTSINSTANCEDBASEINSTANCEPROC
+    gl_ext_glDrawElementsInstancedBaseInstance;
+extern PFNGLDRAWELEMENTSINSTANCEDBASEVERTEXBASEINSTANCEPROC
+    gl_ext_glDrawElementsInstancedBaseVertexBaseInstance;
+#define glDrawArraysInstancedBaseInstance \
+  gl_ext_glDrawArraysInstancedBaseInstance
+#define glDrawElementsInstancedBaseInstance \
+  gl_ext_glDrawElementsInstancedBaseInstance
+#define glDrawElementsInstancedBaseVertexBaseInstance \
+  gl_ext_glDrawElementsInstancedBaseVertexBaseInstance
+
+// GL 4.3 / ARB_multi_draw_indirect (the buffer target is GL 4.0 /
+// ARB_draw_indirect, which both imply)
+#ifndef GL_DRAW_INDIRECT_BUFFER
+#define GL_DRAW_INDIRECT_BUFFER 0x8F3F
+#endif
+typedef void(APIENTRYP PFNGLMULTIDRAWELEMENTSINDIRECTPROC)(
+    GLenum mode, GLenum type, const void* indirect, GLsizei drawcount,
+    GLsizei stride);
+extern PFNGLMULTIDRAWELEMENTSINDIRECTPROC gl_ext_glMultiDrawElementsIndirect;
+#define glMultiDrawElementsIndirect gl_ext_glMultiDrawElementsIndirect
@@ -0,0 +1,88 @@
+#include "gpu_buffer.h"
+#include <stddef.h>
+#include "renderer.h"
+
+unsigned int gpu_buffer_usage_gl(buffer_usage_t usage) {
+  switch (usage) {
+    case BUFFER_USAGE_DYNAMIC:
+      return GL_DYNAMIC_DRAW;
+    case BUFFER_USAGE_STREAM:
+      return GL_STREAM_DRAW;
+    default:
+      return GL_STATIC_DRAW;
+  }
+}
+
+unsigned int gpu_buffer_create(const void* data, unsigned int size,
+                               unsigned int capacity, buffer_usage_t usage) {
+  unsigned int buffer;
+  if (capacity < size) capacity = size;
+
+  GLCall(glGenBuffers(1, &buffer));
+  GLCall(glBindBuffer(GL_COPY_WRITE_BUFFER, buffer));
+  if (capacity == size) {
+    GLCall(glBufferData(GL_COPY_WRITE_BUFFER, capacity, data,
+                        gpu_buffer_usage_gl(usage)));
+  } else {
+    GLCall(glBufferData(GL_COPY_WRITE_BUFFER, capacity, NULL,
+                        gpu_buffer_usage_gl(usage)));
+    if (data && size) {
+      GLCall(glBufferSubData(GL_COPY_WRITE_BUFFER, 0, size, data));
+    }
+  }
+
+  return buffer;
+}
+
+void gpu_buffer_destroy(unsigned int buffer) {
+  renderer_forget_buffer(buffer);
+  GLCall(glDeleteBuffers(1, &buffer));
+}
+
+void gpu_buffer_update(unsigned int buffer, unsigned int offset,
+                       const void* data, unsigned int size) {
+  if (!size) return;
+  GLCall(glBindBuffer(GL_COPY_WRITE_BUFFER, buffer));
+  GLCall(glBufferSubData(GL_COPY_WRITE_BUFFER, offset, size, data));
+}
+
+void gpu_buffer_orphan(unsigned int buffer, unsigned int capacity,
+                       buffer_usage_t usage) {
+  GLCall(glBindBuffer(GL_COPY_WRITE_BUFFER, buffer));
+  GLCall(glBufferData(GL_COPY_WRITE_BUFFER, capacity, NULL,
+                      gpu_buffer_usage_gl(usage)));
+}
+
+void gpu_buffer_resize(unsigned int buffer, unsigned int keep,
+                       unsigned int new_capacity, buffer_usage_t usage) {
+  if (keep > new_capacity) keep = new_capacity;
+
+  if (!keep) {
+    gpu_buffer_orphan(buffer, new_capacity, usage);
+    return;
+  }
+
+  // Park the live bytes in a scratch buffer, respecify the storage under the
+  // same name and copy them back
+  unsigned int scratch;
+  GLCall(glGenBuffers(1, &scratch));
+  GLCall(glBindBuffer(GL_COPY_WRITE_BUFFER, scratch));
+  GLCall(glBufferData(GL_COPY_WRITE_BUFFER, keep, NULL, GL_STREAM_COPY));
+  GLCall(glBindBuffer(GL_COPY_READ_BUFFER, buffer));
+  GLCall(glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, 0, 0,
+                             keep));
+
+  GLCall(glBufferData(GL_COPY_READ_BUFFER, new_capacity, NULL,
+                      gpu_buffer_usage_gl(usage)));
+  GLCall(glCopyBufferSubData(GL_COPY_WRITE_BUFFER, GL_COPY_READ_BUFFER, 0, 0,
+                             keep));
+
+  GLCall(glDeleteBuffers(1, &scratch));
+}
+
+unsigned int gpu_buffer_grow_capacity(unsigned int capacity,
+                                      unsigned int required) {
+  unsigned int grown = capacity * 2;
+  if (grown < capacity) grown = required;  // Overflow
+  return grown > required ? grown : required;
+}
@@ -0,0 +1,42 @@
+#pragma once
+
+// How often a buffer's contents are expected to change
+typedef enum buffer_usage {
+  BUFFER_USAGE_STATIC,   // Uploaded once, drawn many times
+  BUFFER_USAGE_DYNAMIC,  // Updated now and then, drawn many times
+  BUFFER_USAGE_STREAM    // Rewritten about every time it is drawn
+} buffer_usage_t;
+
+// Shared storage management for vertex and index buffers. These work
+// through GL_COPY_READ/WRITE_BUFFER so neither the array buffer binding nor
+// the bound vertex array's element buffer is disturbed.
+
+// GL usage hint (e.g., GL_STATIC_DRAW) for a usage
+unsigned int gpu_buffer_usage_gl(buffer_usage_t usage);
+
+// Create a buffer of capacity bytes, filling the first size bytes from data
+// (which may be NULL)
+unsigned int gpu_buffer_create(const void* data, unsigned int size,
+                               unsigned int capacity, buffer_usage_t usage);
+
+void gpu_buffer_destroy(unsigned int buffer);
+
+// Write size bytes at offset, which must fit the current capacity
+void gpu_buffer_update(unsigned int buffer, unsigned int offset,
+                       const void* data, unsigned int size);
+
+// Give the buffer fresh storage of capacity bytes so pending draws from the
+// old contents do not stall the next upload
+void gpu_buffer_orphan(unsigned int buffer, unsigned int capacity,
+                       buffer_usage_t usage);
+
+// Reallocate to new_capacity bytes keeping the first keep bytes. The copy
+// stays on the GPU (glCopyBufferSubData through a scratch buffer) and the
+// buffer keeps its name, so vertex arrays referencing it remain valid.
+void gpu_buffer_resize(unsigned int buffer, unsigned int keep,
+                       unsigned int new_capacity, buffer_usage_t usage);
+
+// Capacity to grow to so that at least required bytes fit: double the
+// current capacity, or required if that is larger
+unsigned int gpu_buffer_grow_capacity(unsigned int capacity,
+                                      unsigned int required);
@@ -0,0 +1,20 @@
+#include "hash.h"
+#include <string.h>
+
+#define FNV_PRIME 0x100000001b3ull
+
+uint64_t hash_bytes(const void* data, size_t size, uint64_t seed) {
+  const unsigned char* bytes = (const unsigned char*)data;
+  uint64_t hash = seed;
+
+  for (size_t i = 0; i < size; i++) {
+    hash ^= bytes[i];
+    hash *= FNV_PRIME;
+  }
+
+  return hash;
+}
+
+uint64_t hash_string(const char* string, uint64_t seed) {
+  return string ? hash_bytes(string, strlen(string), seed) : seed;
+}
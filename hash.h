@@ -0,0 +1,12 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+
+#define HASH_SEED 0xcbf29ce484222325ull  // FNV-1a 64-bit offset basis
+
+// 64-bit FNV-1a. Pass HASH_SEED to start, or a previous result to chain
+// several buffers into one hash.
+uint64_t hash_bytes(const void* data, size_t size, uint64_t seed);
+
+// Chain a NUL terminated string (NULL hashes like "")
+uint64_t hash_string(const char* string, uint64_t seed);
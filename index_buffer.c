@@ -1,38 +1,175 @@
 #include "index_buffer.h"
+#include <stdlib.h>
 #include "renderer.h"
 
+#if defined(__SSE2__) || defined(_M_X64) || \
+    (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define INDEX_BUFFER_SSE2 1
+#elif defined(__ARM_NEON) || defined(_M_ARM64)
+#include <arm_neon.h>
+#define INDEX_BUFFER_NEON 1
+#endif
+
+static unsigned int type_size(unsigned int type) {
+  switch (type) {
+    case GL_UNSIGNED_BYTE:
+      return 1;
+    case GL_UNSIGNED_SHORT:
+      return 2;
+    default:
+      return 4;
+  }
+}
+
+static unsigned int type_max(unsigned int type) {
+  switch (type) {
+    case GL_UNSIGNED_BYTE:
+      return 0xFFu;
+    case GL_UNSIGNED_SHORT:
+      return 0xFFFFu;
+    default:
+      return 0xFFFFFFFFu;
+  }
+}
+
+unsigned int index_buffer_find_max(const unsigned int* data,
+                                   unsigned int count) {
+  unsigned int max = 0;
+  unsigned int i = 0;
+
+#if defined(INDEX_BUFFER_SSE2)
+  if (count >= 16) {
+    // SSE2 only has a signed 32-bit compare, so flip the sign bits to
+    // compare as unsigned, and keep four running maxima of 4 lanes
+    const __m128i bias = _mm_set1_epi32((int)0x80000000u);
+    __m128i m0 = bias, m1 = bias, m2 = bias, m3 = bias;
+    for (; i + 16 <= count; i += 16) {
+      __m128i v0 = _mm_xor_si128(
+          _mm_loadu_si128((const __m128i*)(data + i)), bias);
+      __m128i v1 = _mm_xor_si128(
+          _mm_loadu_si128((const __m128i*)(data + i + 4)), bias);
+      __m128i v2 = _mm_xor_si128(
+          _mm_loadu_si128((const __m128i*)(data + i + 8)), bias);
+      __m128i v3 = _mm_xor_si128(
+          _mm_loadu_si128((const __m128i*)(data + i + 12)), bias);
+      __m128i g0 = _mm_cmpgt_epi32(v0, m0);
+      __m128i g1 = _mm_cmpgt_epi32(v1, m1);
+      __m128i g2 = _mm_cmpgt_epi32(v2, m2);
+      __m128i g3 = _mm_cmpgt_epi32(v3, m3);
+      m0 = _mm_or_si128(_mm_and_si128(g0, v0), _mm_andnot_si128(g0, m0));
+      m1 = _mm_or_si128(_mm_and_si128(g1, v1), _mm_andnot_si128(g1, m1));
+      m2 = _mm_or_si128(_mm_and_si128(g2, v2), _mm_andnot_si128(g2, m2));
+      m3 = _mm_or_si128(_mm_and_si128(g3, v3), _mm_andnot_si128(g3, m3));
+    }
+
+    unsigned int lanes[16];
+    _mm_storeu_si128((__m128i*)lanes, _mm_xor_si128(m0, bias));
+    _mm_storeu_si128((__m128i*)(lanes + 4), _mm_xor_si128(m1, bias));
+    _mm_storeu_si128((__m128i*)(lanes + 8), _mm_xor_si128(m2, bias));
+    _mm_storeu_si128((__m128i*)(lanes + 12), _mm_xor_si128(m3, bias));
+    for (int lane = 0; lane < 16; lane++) {
+      if (lanes[lane] > max) max = lanes[lane];
+    }
+  }
+#elif defined(INDEX_BUFFER_NEON)
+  if (count >= 8) {
+    uint32x4_t m0 = vdupq_n_u32(0), m1 = vdupq_n_u32(0);
+    for (; i + 8 <= count; i += 8) {
+      m0 = vmaxq_u32(m0, vld1q_u32(data + i));
+      m1 = vmaxq_u32(m1, vld1q_u32(data + i + 4));
+    }
+#if defined(__aarch64__) || defined(_M_ARM64)
+    max = vmaxvq_u32(vmaxq_u32(m0, m1));
+#else
+    // No across-vector max on 32-bit ARM; fold pairwise
+    uint32x4_t m = vmaxq_u32(m0, m1);
+    uint32x2_t pair = vpmax_u32(vget_low_u32(m), vget_high_u32(m));
+    max = vget_lane_u32(vpmax_u32(pair, pair), 0);
+#endif
+  }
+#endif
+
+  for (; i < count; i++) {
+    if (data[i] > max) max = data[i];
+  }
+  return max;
+}
+
+unsigned int index_buffer_type_for_max(unsigned int max_index) {
+#if INDEX_BUFFER_ALLOW_UBYTE
+  if (max_index <= 0xFFu) return GL_UNSIGNED_BYTE;
+#endif
+  if (max_index <= 0xFFFFu) return GL_UNSIGNED_SHORT;
+  return GL_UNSIGNED_INT;
+}
+
+// Narrow count indices into type. Returns the packed copy, or data itself
+// when no conversion is needed; free it with release_packed.
+static const void* pack_indices(const unsigned int* data, unsigned int count,
+                                unsigned int type) {
+  if (type == GL_UNSIGNED_INT || !data) return data;
+
+  if (type == GL_UNSIGNED_SHORT) {
+    unsigned short* packed =
+        (unsigned short*)malloc(count * sizeof(unsigned short));
+    for (unsigned int i = 0; i < count; i++)
+      packed[i] = (unsigned short)data[i];
+    return packed;
+  }
+
+  unsigned char* packed = (unsigned char*)malloc(count);
+  for (unsigned int i = 0; i < count; i++) packed[i] = (unsigned char)data[i];
+  return packed;
+}
+
+static void release_packed(const void* packed, const unsigned int* data) {
+  if (packed != data) free((void*)packed);
+}
+
 index_buffer_t index_buffer_create(const unsigned int* data,
                                    unsigned int count) {
+  return index_buffer_create_with_usage(data, count, BUFFER_USAGE_STATIC);
+}
+
+index_buffer_t index_buffer_create_with_usage(const unsigned int* data,
+                                              unsigned int count,
+                                              buffer_usage_t usage) {
   index_buffer_t buffer;
 
-  // ASSERT(sizeof(unsigned int) == sizeof(GLunit));
+  unsigned int max_index = data ? index_buffer_find_max(data, count) : 0;
+  buffer.m_type = index_buffer_type_for_max(max_index);
 
-  GLCall(glGenBuffers(1, &buffer.m_renderer_id));
-  GLCall(glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, buffer.m_renderer_id));
-  GLCall(glBufferData(GL_ELEMENT_ARRAY_BUFFER, count * sizeof(unsigned int),
-                      data, GL_STATIC_DRAW));
+  unsigned int size = count * type_size(buffer.m_type);
+  const void* packed = pack_indices(data, count, buffer.m_type);
+  buffer.m_renderer_id = gpu_buffer_create(packed, size, size, usage);
+  release_packed(packed, data);
 
-  buffer.m_count = count;
+  buffer.m_count = data ? count : 0;
+  buffer.m_capacity = count;
+  buffer.m_usage = usage;
 
   return buffer;
 }
 
 void index_buffer_destroy(index_buffer_t* buffer) {
   if (buffer) {
-    GLCall(glDeleteBuffers(1, &buffer->m_renderer_id));
+    gpu_buffer_destroy(buffer->m_renderer_id);
     buffer->m_renderer_id = 0;  // Set to 0 to mark as deleted
+    buffer->m_count = 0;
+    buffer->m_capacity = 0;
   }
 }
 
 void index_buffer_bind(index_buffer_t* buffer) {
   if (buffer) {
-    GLCall(glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, buffer->m_renderer_id));
+    renderer_bind_buffer(GL_ELEMENT_ARRAY_BUFFER, buffer->m_renderer_id);
   }
 }
 
 void index_buffer_unbind(void) {
   // Unbinding doesn't need the buffer pointer - just bind 0
-  GLCall(glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0));
+  renderer_bind_buffer(GL_ELEMENT_ARRAY_BUFFER, 0);
 }
 
 unsigned int index_buffer_get_count(const index_buffer_t* buffer) {
@@ -40,4 +177,105 @@ unsigned int index_buffer_get_count(const index_buffer_t* buffer) {
     return buffer->m_count;
   }
   return 0;  // Return 0 if buffer is NULL
-}
\ No newline at end of file
+}
+
+unsigned int index_buffer_get_capacity(const index_buffer_t* buffer) {
+  return buffer ? buffer->m_capacity : 0;
+}
+
+unsigned int index_buffer_get_type(const index_buffer_t* buffer) {
+  return buffer ? buffer->m_type : GL_UNSIGNED_INT;
+}
+
+unsigned int index_buffer_get_index_size(const index_buffer_t* buffer) {
+  return type_size(index_buffer_get_type(buffer));
+}
+
+void index_buffer_reserve(index_buffer_t* buffer, unsigned int capacity) {
+  if (!buffer || capacity <= buffer->m_capacity) return;
+
+  unsigned int size = type_size(buffer->m_type);
+  capacity = gpu_buffer_grow_capacity(buffer->m_capacity, capacity);
+  gpu_buffer_resize(buffer->m_renderer_id, buffer->m_count * size,
+                    capacity * size, buffer->m_usage);
+  buffer->m_capacity = capacity;
+}
+
+// Re-store the existing contents in a wider type. This reads the buffer
+// back, so it stalls, but only happens when an update first exceeds the
+// current type's range.
+static void widen(index_buffer_t* buffer, unsigned int type) {
+  unsigned int old_size = type_size(buffer->m_type);
+  unsigned int count = buffer->m_count;
+  unsigned char* old_data = (unsigned char*)malloc(count * old_size + 1);
+  unsigned int* indices =
+      (unsigned int*)malloc((count ? count : 1) * sizeof(unsigned int));
+
+  if (count) {
+    GLCall(glBindBuffer(GL_COPY_READ_BUFFER, buffer->m_renderer_id));
+    GLCall(glGetBufferSubData(GL_COPY_READ_BUFFER, 0, count * old_size,
+                              old_data));
+  }
+  for (unsigned int i = 0; i < count; i++) {
+    if (old_size == 1) {
+      indices[i] = old_data[i];
+    } else {
+      indices[i] = ((unsigned short*)old_data)[i];
+    }
+  }
+
+  buffer->m_type = type;
+  gpu_buffer_orphan(buffer->m_renderer_id, buffer->m_capacity * type_size(type),
+                    buffer->m_usage);
+  const void* packed = pack_indices(indices, count, type);
+  gpu_buffer_update(buffer->m_renderer_id, 0, packed, count * type_size(type));
+  release_packed(packed, indices);
+
+  free(indices);
+  free(old_data);
+}
+
+void index_buffer_update(index_buffer_t* buffer, unsigned int first,
+                         const unsigned int* data, unsigned int count) {
+  if (!buffer) return;
+
+  unsigned int max_index = index_buffer_find_max(data, count);
+  if (max_index > type_max(buffer->m_type)) {
+    widen(buffer, index_buffer_type_for_max(max_index));
+  }
+
+  index_buffer_reserve(buffer, first + count);
+
+  unsigned int size = type_size(buffer->m_type);
+  const void* packed = pack_indices(data, count, buffer->m_type);
+  gpu_buffer_update(buffer->m_renderer_id, first * size, packed, count * size);
+  release_packed(packed, data);
+
+  if (first + count > buffer->m_count) buffer->m_count = first + count;
+}
+
+void index_buffer_set_data(index_buffer_t* buffer, const unsigned int* data,
+                           unsigned int count) {
+  if (!buffer) return;
+
+  // Nothing is kept, so the type can be picked afresh (narrower included)
+  unsigned int type =
+      index_buffer_type_for_max(index_buffer_find_max(data, count));
+  bool type_changed = type != buffer->m_type;
+  buffer->m_type = type;
+  unsigned int size = type_size(type);
+
+  if (count > buffer->m_capacity) {
+    buffer->m_capacity = gpu_buffer_grow_capacity(buffer->m_capacity, count);
+    gpu_buffer_orphan(buffer->m_renderer_id, buffer->m_capacity * size,
+                      buffer->m_usage);
+  } else if (type_changed || buffer->m_usage != BUFFER_USAGE_STATIC) {
+    gpu_buffer_orphan(buffer->m_renderer_id, buffer->m_capacity * size,
+                      buffer->m_usage);
+  }
+
+  const void* packed = pack_indices(data, count, type);
+  gpu_buffer_update(buffer->m_renderer_id, 0, packed, count * size);
+  release_packed(packed, data);
+  buffer->m_count = count;
+}
@@ -1,16 +1,52 @@
 #pragma once
+#include "gpu_buffer.h"
+
+// Indices are always passed in as unsigned int but stored in the smallest
+// GL type that holds the largest one, halving index bandwidth for most
+// meshes. GL_UNSIGNED_BYTE is only picked when INDEX_BUFFER_ALLOW_UBYTE is
+// defined to 1, since several desktop GPUs convert byte indices in the
+// driver and end up slower than 16-bit ones.
+#ifndef INDEX_BUFFER_ALLOW_UBYTE
+#define INDEX_BUFFER_ALLOW_UBYTE 0
+#endif
 
 typedef struct index_buffer {
   unsigned int m_renderer_id;
   unsigned int m_count;
+  unsigned int m_capacity;  // Indices allocated on the GPU
+  unsigned int m_type;      // GL_UNSIGNED_BYTE, _SHORT or _INT
+  buffer_usage_t m_usage;
 } index_buffer_t;
 
 index_buffer_t index_buffer_create(const unsigned int* data,
                                    unsigned int count);
-
+index_buffer_t index_buffer_create_with_usage(const unsigned int* data,
+                                              unsigned int count,
+                                              buffer_usage_t usage);
 void index_buffer_destroy(index_buffer_t* buffer);
-
 void index_buffer_bind(index_buffer_t* buffer);
 void index_buffer_unbind(void);
+unsigned int index_buffer_get_count(const index_buffer_t* buffer);
+unsigned int index_buffer_get_capacity(const index_buffer_t* buffer);
+// GL type to pass to glDrawElements
+unsigned int index_buffer_get_type(const index_buffer_t* buffer);
+// Bytes per stored index
+unsigned int index_buffer_get_index_size(const index_buffer_t* buffer);
+
+// Write count indices starting at index first, growing the buffer if they
+// do not fit. Widens the stored type (re-reading the old contents) if an
+// index does not fit it.
+void index_buffer_update(index_buffer_t* buffer, unsigned int first,
+                         const unsigned int* data, unsigned int count);
+// Replace the whole contents, reusing the allocation when it is big enough
+void index_buffer_set_data(index_buffer_t* buffer, const unsigned int* data,
+                           unsigned int count);
+// Make room for at least capacity indices, growing geometrically
+void index_buffer_reserve(index_buffer_t* buffer, unsigned int capacity);
+
+// Largest value in data (0 if count is 0). Vectorized for SSE2 and NEON.
+unsigned int index_buffer_find_max(const unsigned int* data,
+                                   unsigned int count);
 
-unsigned int index_buffer_get_count(const index_buffer_t* buffer);
\ No newline at end of file
+// Smallest GL index type able to hold max_index
+unsigned int index_buffer_type_for_max(unsigned int max_index);
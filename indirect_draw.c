@@ -0,0 +1,167 @@
+#include "indirect_draw.h"
+#include <stddef.h>
+#include <stdlib.h>
+#include "gl_ext.h"
+#include "gpu_buffer.h"
+#include "renderer.h"
+
+#define INITIAL_CAPACITY 64
+
+indirect_draw_list_t indirect_draw_list_create(void) {
+  indirect_draw_list_t list;
+
+  list.commands = (draw_elements_indirect_command_t*)malloc(
+      INITIAL_CAPACITY * sizeof(draw_elements_indirect_command_t));
+  list.command_count = 0;
+  list.commands_capacity = INITIAL_CAPACITY;
+  list.instance_count = 0;
+
+  list.m_renderer_id = 0;
+  list.buffer_capacity = 0;
+  list.dirty = false;
+
+  list.counts = (int*)malloc(INITIAL_CAPACITY * sizeof(int));
+  list.offsets = (const void**)malloc(INITIAL_CAPACITY * sizeof(void*));
+  list.base_vertices = (int*)malloc(INITIAL_CAPACITY * sizeof(int));
+
+  list.stats.draws = 0;
+  list.stats.gl_calls = 0;
+
+  return list;
+}
+
+void indirect_draw_list_destroy(indirect_draw_list_t* list) {
+  if (list && list->commands) {
+    if (list->m_renderer_id) gpu_buffer_destroy(list->m_renderer_id);
+    free(list->commands);
+    free(list->counts);
+    free(list->offsets);
+    free(list->base_vertices);
+    list->commands = NULL;
+    list->command_count = 0;
+    list->commands_capacity = 0;
+    list->m_renderer_id = 0;
+    list->buffer_capacity = 0;
+  }
+}
+
+void indirect_draw_list_clear(indirect_draw_list_t* list) {
+  list->command_count = 0;
+  list->instance_count = 0;
+  list->dirty = true;
+}
+
+static void ensure_capacity(indirect_draw_list_t* list) {
+  if (list->command_count < list->commands_capacity) return;
+
+  list->commands_capacity *= 2;
+  list->commands = (draw_elements_indirect_command_t*)realloc(
+      list->commands,
+      list->commands_capacity * sizeof(draw_elements_indirect_command_t));
+  list->counts =
+      (int*)realloc(list->counts, list->commands_capacity * sizeof(int));
+  list->offsets = (const void**)realloc(
+      list->offsets, list->commands_capacity * sizeof(void*));
+  list->base_vertices = (int*)realloc(list->base_vertices,
+                                      list->commands_capacity * sizeof(int));
+}
+
+unsigned int indirect_draw_list_add(indirect_draw_list_t* list,
+                                    const mesh_arena_mesh_t* mesh,
+                                    unsigned int instance_count) {
+  ensure_capacity(list);
+
+  unsigned int first_instance = list->instance_count;
+  draw_elements_indirect_command_t* command =
+      &list->commands[list->command_count++];
+  command->count = mesh->index_count;
+  command->instance_count = instance_count;
+  command->first_index = mesh->first_index;
+  command->base_vertex = (int)mesh->base_vertex;
+  command->base_instance = first_instance;
+
+  list->instance_count += instance_count;
+  list->dirty = true;
+  return first_instance;
+}
+
+// Upload the commands to the indirect buffer if they changed
+static void upload_commands(indirect_draw_list_t* list) {
+  if (!list->dirty) return;
+
+  unsigned int size =
+      list->command_count * sizeof(draw_elements_indirect_command_t);
+  if (!list->m_renderer_id) {
+    list->buffer_capacity = list->commands_capacity;
+    list->m_renderer_id = gpu_buffer_create(
+        NULL, 0,
+        list->buffer_capacity * sizeof(draw_elements_indirect_command_t),
+        BUFFER_USAGE_STATIC);
+  } else if (list->command_count > list->buffer_capacity) {
+    list->buffer_capacity = list->commands_capacity;
+    gpu_buffer_orphan(
+        list->m_renderer_id,
+        list->buffer_capacity * sizeof(draw_elements_indirect_command_t),
+        BUFFER_USAGE_STATIC);
+  }
+
+  gpu_buffer_update(list->m_renderer_id, 0, list->commands, size);
+  list->dirty = false;
+}
+
+void indirect_draw_list_draw(indirect_draw_list_t* list,
+                             const mesh_arena_t* arena) {
+  list->stats.draws = list->command_count;
+  list->stats.gl_calls = 0;
+  if (list->command_count == 0) return;
+
+  unsigned int type = index_buffer_get_type(&arena->indices);
+  unsigned int index_size = index_buffer_get_index_size(&arena->indices);
+
+  if (gl_ext.multi_draw_indirect) {
+    upload_commands(list);
+    renderer_bind_buffer(GL_DRAW_INDIRECT_BUFFER, list->m_renderer_id);
+    GLCall(glMultiDrawElementsIndirect(GL_TRIANGLES, type, NULL,
+                                       list->command_count, 0));
+    list->stats.gl_calls = 1;
+    return;
+  }
+
+  bool single_instances = list->instance_count == list->command_count;
+  if (!gl_ext.base_instance && single_instances) {
+    for (unsigned int i = 0; i < list->command_count; i++) {
+      const draw_elements_indirect_command_t* command = &list->commands[i];
+      list->counts[i] = (int)command->count;
+      list->offsets[i] = (const void*)(size_t)(command->first_index *
+                                               index_size);
+      list->base_vertices[i] = command->base_vertex;
+    }
+    GLCall(glMultiDrawElementsBaseVertex(
+        GL_TRIANGLES, list->counts, type, (const void* const*)list->offsets,
+        list->command_count, list->base_vertices));
+    list->stats.gl_calls = 1;
+    return;
+  }
+
+  for (unsigned int i = 0; i < list->command_count; i++) {
+    const draw_elements_indirect_command_t* command = &list->commands[i];
+    const void* offset = (const void*)(size_t)(command->first_index *
+                                               index_size);
+    if (gl_ext.base_instance) {
+      GLCall(glDrawElementsInstancedBaseVertexBaseInstance(
+          GL_TRIANGLES, command->count, type, offset, command->instance_count,
+          command->base_vertex, command->base_instance));
+    } else {
+      GLCall(glDrawElementsInstancedBaseVertex(GL_TRIANGLES, command->count,
+                                               type, offset,
+                                               command->instance_count,
+                                               command->base_vertex));
+    }
+    list->stats.gl_calls++;
+  }
+}
+
+indirect_draw_stats_t indirect_draw_list_get_stats(
+    const indirect_draw_list_t* list) {
+  return list->stats;
+}
@@ -0,0 +1,70 @@
+#pragma once
+#include <stdbool.h>
+#include "mesh_arena.h"
+
+// Record layout glMultiDrawElementsIndirect reads
+typedef struct draw_elements_indirect_command {
+  unsigned int count;
+  unsigned int instance_count;
+  unsigned int first_index;
+  int base_vertex;
+  unsigned int base_instance;
+} draw_elements_indirect_command_t;
+
+// Counters for the last indirect_draw_list_draw
+typedef struct indirect_draw_stats {
+  unsigned int draws;     // Commands drawn
+  unsigned int gl_calls;  // GL draw calls it took
+} indirect_draw_stats_t;
+
+// A list of draws of meshes in one mesh_arena, submitted together. Built
+// once for static scenes; the commands are only uploaded again after they
+// change. Submission picks the best path the context has:
+//   multi_draw_indirect - one glMultiDrawElementsIndirect from a buffer
+//   base_instance       - a glDrawElementsInstancedBaseVertexBaseInstance
+//                         per draw
+//   GL 3.3              - one glMultiDrawElementsBaseVertex, or a draw per
+//                         command once any has more than one instance
+//
+// Per-draw data: each command's base_instance is the sum of the instance
+// counts before it, so an instanced attribute (layout divisor 1) whose
+// element i holds the data for instance i reaches the right draw. Shaders
+// with ARB_shader_draw_parameters can use gl_DrawIDARB instead. The GL 3.3
+// path has no base instance, so there every draw sees element 0.
+typedef struct indirect_draw_list {
+  draw_elements_indirect_command_t* commands;
+  unsigned int command_count;
+  unsigned int commands_capacity;
+  unsigned int instance_count;  // Sum over the commands
+
+  unsigned int m_renderer_id;    // GL_DRAW_INDIRECT_BUFFER, 0 without MDI
+  unsigned int buffer_capacity;  // Commands the GL buffer can hold
+  bool dirty;                    // Commands changed since the upload
+
+  // glMultiDrawElementsBaseVertex arguments for the GL 3.3 path
+  int* counts;
+  const void** offsets;
+  int* base_vertices;
+
+  indirect_draw_stats_t stats;
+} indirect_draw_list_t;
+
+indirect_draw_list_t indirect_draw_list_create(void);
+void indirect_draw_list_destroy(indirect_draw_list_t* list);
+
+// Remove every command
+void indirect_draw_list_clear(indirect_draw_list_t* list);
+
+// Queue instance_count instances of an arena mesh. Returns the index of the
+// first instance, i.e. where its per-draw data goes.
+unsigned int indirect_draw_list_add(indirect_draw_list_t* list,
+                                    const mesh_arena_mesh_t* mesh,
+                                    unsigned int instance_count);
+
+// Draw every command. The program and the vertex array describing the
+// arena's buffers must be bound, as for mesh_arena_draw.
+void indirect_draw_list_draw(indirect_draw_list_t* list,
+                             const mesh_arena_t* arena);
+
+indirect_draw_stats_t indirect_draw_list_get_stats(
+    const indirect_draw_list_t* list);
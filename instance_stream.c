@@ -0,0 +1,140 @@
+#include "instance_stream.h"
+#include <string.h>
+#include "gl_ext.h"
+#include "renderer.h"
+
+#define FRAMES_IN_FLIGHT 3
+
+static void reset_stats(instance_stream_t* stream) {
+  stream->stats.draws = 0;
+  stream->stats.instances = 0;
+  stream->stats.dropped = 0;
+  stream->stats.bytes = 0;
+}
+
+instance_stream_t instance_stream_create(unsigned int frame_size) {
+  instance_stream_t stream;
+
+  stream.buffer =
+      stream_buffer_create(GL_ARRAY_BUFFER, frame_size, FRAMES_IN_FLIGHT);
+  reset_stats(&stream);
+
+  return stream;
+}
+
+void instance_stream_destroy(instance_stream_t* stream) {
+  if (stream) {
+    stream_buffer_destroy(&stream->buffer);
+  }
+}
+
+void instance_stream_begin_frame(instance_stream_t* stream) {
+  stream_buffer_begin_frame(&stream->buffer);
+  reset_stats(stream);
+}
+
+void instance_stream_end_frame(instance_stream_t* stream) {
+  stream_buffer_end_frame(&stream->buffer);
+}
+
+// Draw index_count indices from first_index, offset by base_vertex, once per
+// instance, streaming the instance data through the frame's region
+static void draw_instanced(instance_stream_t* stream, vertex_array_t* array,
+                           index_buffer_t* indices, unsigned int index_count,
+                           unsigned int first_index, unsigned int base_vertex,
+                           unsigned int shader, unsigned int binding,
+                           const vertex_buffer_layout_t* layout,
+                           const void* instances,
+                           unsigned int instance_count) {
+  unsigned int stride = vertex_buffer_layout_get_stride(layout);
+  if (!stride) return;
+
+  // The stream's GL buffer seen as a vertex buffer for binding
+  vertex_buffer_t view;
+  view.m_renderer_id = stream->buffer.m_renderer_id;
+  view.m_size = stream->buffer.region_size * stream->buffer.region_count;
+  view.m_capacity = view.m_size;
+  view.m_usage = BUFFER_USAGE_STREAM;
+
+  renderer_use_program(shader);
+  vertex_array_bind(array);
+  index_buffer_bind(indices);
+
+  unsigned int type = index_buffer_get_type(indices);
+  const void* first = (const void*)(size_t)(
+      first_index * index_buffer_get_index_size(indices));
+
+  const unsigned char* source = (const unsigned char*)instances;
+  unsigned int drawn = 0;
+  while (drawn < instance_count) {
+    // Whatever still fits in this frame's region
+    unsigned int start = (stream->buffer.offset + stride - 1) / stride * stride;
+    unsigned int available =
+        start < stream->buffer.region_size
+            ? (stream->buffer.region_size - start) / stride
+            : 0;
+    unsigned int count = instance_count - drawn;
+    if (count > available) count = available;
+    if (!count) break;
+
+    unsigned int offset;
+    void* destination =
+        stream_buffer_alloc(&stream->buffer, count * stride, stride, &offset);
+    if (!destination) break;
+
+    memcpy(destination, source + (size_t)drawn * stride,
+           (size_t)count * stride);
+    stream_buffer_flush(&stream->buffer);
+
+    if (gl_ext.base_instance && offset % stride == 0) {
+      // Bound once at the start of the buffer; each draw picks its data
+      // with baseinstance, so the bind cache elides every later rebind
+      vertex_array_set_vertex_buffer(array, binding, &view, layout, 0);
+      if (base_vertex) {
+        GLCall(glDrawElementsInstancedBaseVertexBaseInstance(
+            GL_TRIANGLES, index_count, type, first, count, base_vertex,
+            offset / stride));
+      } else {
+        GLCall(glDrawElementsInstancedBaseInstance(
+            GL_TRIANGLES, index_count, type, first, count, offset / stride));
+      }
+    } else {
+      vertex_array_set_vertex_buffer(array, binding, &view, layout, offset);
+      GLCall(glDrawElementsInstancedBaseVertex(
+          GL_TRIANGLES, index_count, type, first, count, base_vertex));
+    }
+
+    stream->stats.draws++;
+    stream->stats.instances += count;
+    stream->stats.bytes += count * stride;
+    drawn += count;
+  }
+
+  stream->stats.dropped += instance_count - drawn;
+}
+
+void instance_stream_draw(instance_stream_t* stream, vertex_array_t* array,
+                          index_buffer_t* indices, unsigned int shader,
+                          unsigned int binding,
+                          const vertex_buffer_layout_t* layout,
+                          const void* instances, unsigned int instance_count) {
+  draw_instanced(stream, array, indices, index_buffer_get_count(indices), 0, 0,
+                 shader, binding, layout, instances, instance_count);
+}
+
+void instance_stream_draw_mesh(instance_stream_t* stream,
+                               vertex_array_t* array, mesh_arena_t* arena,
+                               const mesh_arena_mesh_t* mesh,
+                               unsigned int shader, unsigned int binding,
+                               const vertex_buffer_layout_t* layout,
+                               const void* instances,
+                               unsigned int instance_count) {
+  draw_instanced(stream, array, &arena->indices, mesh->index_count,
+                 mesh->first_index, mesh->base_vertex, shader, binding, layout,
+                 instances, instance_count);
+}
+
+instance_stream_stats_t instance_stream_get_stats(
+    const instance_stream_t* stream) {
+  return stream->stats;
+}
@@ -0,0 +1,57 @@
+#pragma once
+#include "index_buffer.h"
+#include "mesh_arena.h"
+#include "stream_buffer.h"
+#include "vertex_array.h"
+#include "vertex_buffer_layout.h"
+
+// Counters since the last instance_stream_begin_frame
+typedef struct instance_stream_stats {
+  unsigned int draws;      // GL draw calls issued
+  unsigned int instances;  // Instances drawn
+  unsigned int dropped;    // Instances skipped because the frame was full
+  unsigned int bytes;      // Per-instance data uploaded
+} instance_stream_stats_t;
+
+// Uploads dense per-instance data (transforms, colors, ...) each frame
+// through a stream_buffer and draws a mesh once per element with
+// glDrawElementsInstanced. With base instance (GL 4.2) the instance binding
+// stays put and each draw starts at its data with baseinstance; otherwise
+// the binding is moved to the data's offset.
+typedef struct instance_stream {
+  stream_buffer_t buffer;
+  instance_stream_stats_t stats;
+} instance_stream_t;
+
+// frame_size is the per-instance bytes one frame can hold
+instance_stream_t instance_stream_create(unsigned int frame_size);
+void instance_stream_destroy(instance_stream_t* stream);
+
+void instance_stream_begin_frame(instance_stream_t* stream);
+// Call once the frame's draws are submitted
+void instance_stream_end_frame(instance_stream_t* stream);
+
+// Draw instance_count instances of the mesh. array must have the instance
+// layout (divisor 1) set as the format of binding with
+// vertex_array_set_format; instances holds instance_count elements of
+// layout's stride. Instances that no longer fit in the frame are dropped
+// and counted in the stats, so size frame_size for the worst frame.
+void instance_stream_draw(instance_stream_t* stream, vertex_array_t* array,
+                          index_buffer_t* indices, unsigned int shader,
+                          unsigned int binding,
+                          const vertex_buffer_layout_t* layout,
+                          const void* instances, unsigned int instance_count);
+
+// As instance_stream_draw, for one mesh of an arena: array describes the
+// arena's buffers, and the mesh's base vertex and first index are passed
+// with each draw
+void instance_stream_draw_mesh(instance_stream_t* stream,
+                               vertex_array_t* array, mesh_arena_t* arena,
+                               const mesh_arena_mesh_t* mesh,
+                               unsigned int shader, unsigned int binding,
+                               const vertex_buffer_layout_t* layout,
+                               const void* instances,
+                               unsigned int instance_count);
+
+instance_stream_stats_t instance_stream_get_stats(
+    const instance_stream_t* stream);
@@ -1,5 +1,3 @@
-#define GLFW_INCLUDE_NONE
-#include <GLFW/glfw3.h>
 #include <glad/glad.h>
 #include <stdio.h>
 #include <stdlib.h>
@@ -7,224 +5,116 @@
 
 #include "renderer.h"
 
-#include "index_buffer.h"
-#include "vertex_array.h"
-#include "vertex_buffer.h"
-
-struct ShaderProgramSource {
-  char* VertexSource;
-  char* FragmentSource;
-};
-
-struct ShaderProgramSource parse_shader(const char* filepath) {
-  FILE* file = fopen(filepath, "rb");
-  if (!file) {
-    fprintf(stderr, "Failed to open shader file: %s\n", filepath);
-    struct ShaderProgramSource empty = {NULL, NULL};
-    return empty;
-  }
-
-  fseek(file, 0, SEEK_END);
-  long length = ftell(file);
-  fseek(file, 0, SEEK_SET);
-
-  char* buffer = malloc(length + 1);
-  fread(buffer, 1, length, file);
-  buffer[length] = '\0';
-  fclose(file);
-
-  struct ShaderProgramSource result = {NULL, NULL};
-  char* vertex_start = NULL;
-  char* fragment_start = NULL;
-  char* current = buffer;
-
-  // Find shader sections
-  while (*current) {
-    if (strstr(current, "#shader vertex") == current) {
-      current += strlen("#shader vertex");
-      // Skip whitespace and newlines
-      while (*current && (*current == ' ' || *current == '\n' ||
-                          *current == '\r' || *current == '\t'))
-        current++;
-      vertex_start = current;
-    } else if (strstr(current, "#shader fragment") == current) {
-      if (vertex_start) {
-        // Properly terminate vertex shader
-        *current = '\0';
-        // Remove trailing whitespace from vertex shader
-        char* end = current - 1;
-        while (end > vertex_start &&
-               (*end == ' ' || *end == '\n' || *end == '\r' || *end == '\t'))
-          *end-- = '\0';
-      }
-      current += strlen("#shader fragment");
-      // Skip whitespace and newlines
-      while (*current && (*current == ' ' || *current == '\n' ||
-                          *current == '\r' || *current == '\t'))
-        current++;
-      fragment_start = current;
+#include "bench.h"
+#include "context.h"
+#include "scene.h"
+#include "timer.h"
+
+// main [--headless] [--frames N] [--scene NAME] [--expect HEX] [--bench NAME]
+// Draws the named scene (see scene.h, default "basic"). Headless runs
+// render offscreen without vsync for a fixed number of frames and print
+// frame times and an image checksum; they fail if the image is blank or
+// differs from --expect. --bench runs the named benchmark (or "all") on
+// the headless context instead.
+int main(int argc, char** argv) {
+  context_backend_t backend = CONTEXT_BACKEND_WINDOW;
+  unsigned int frames = 0;
+  const char* bench = NULL;
+  const char* scene_name = "basic";
+  const char* expect = NULL;
+  for (int i = 1; i < argc; i++) {
+    if (strcmp(argv[i], "--headless") == 0) {
+      backend = CONTEXT_BACKEND_HEADLESS;
+    } else if (strcmp(argv[i], "--frames") == 0 && i + 1 < argc) {
+      frames = (unsigned int)strtoul(argv[++i], NULL, 10);
+    } else if (strcmp(argv[i], "--bench") == 0 && i + 1 < argc) {
+      bench = argv[++i];
+      backend = CONTEXT_BACKEND_HEADLESS;
+    } else if (strcmp(argv[i], "--scene") == 0 && i + 1 < argc) {
+      scene_name = argv[++i];
+    } else if (strcmp(argv[i], "--expect") == 0 && i + 1 < argc) {
+      expect = argv[++i];
     }
-    current++;
   }
 
-  // Copy the shaders if found
-  if (vertex_start) {
-    size_t vertex_len = strlen(vertex_start);
-    result.VertexSource = malloc(vertex_len + 1);
-    strcpy(result.VertexSource, vertex_start);
-  }
+  context_options_t options = context_default_options(backend);
+  if (frames) options.frames = frames;
 
-  if (fragment_start) {
-    size_t fragment_len = strlen(fragment_start);
-    result.FragmentSource = malloc(fragment_len + 1);
-    strcpy(result.FragmentSource, fragment_start);
-  }
+  context_t context = context_create(&options);
+  if (!context.created) return -1;
 
-  free(buffer);
-  return result;
-}
-
-unsigned int compile_shader(unsigned int type, char* source) {
-  unsigned int id = glCreateShader(type);
-  const char* src = source;
-  GLCall(glShaderSource(id, 1, &src, NULL));
-  GLCall(glCompileShader(id));
-
-  int result;
-  GLCall(glGetShaderiv(id, GL_COMPILE_STATUS, &result));
-  if (result == GL_FALSE) {
-    int length;
-    GLCall(glGetShaderiv(id, GL_INFO_LOG_LENGTH, &length));
-    char* message = (char*)malloc(length * sizeof(char));
-    GLCall(glGetShaderInfoLog(id, length, &length, message));
-    fprintf(stderr, "Failed to compile shader: %s\n", message);
-    free(message);
-    GLCall(glDeleteShader(id));
-    return 0;
+#if RENDERER_GL_DEBUG
+  renderer_debug_options_t debug_options = renderer_debug_default_options();
+  if (!renderer_debug_install(&debug_options)) {
+    printf("No GL debug output, polling glGetError after every call\n");
   }
+#endif
 
-  return id;
-}
-
-unsigned int create_shader(char* vertextShader, char* fragmentShader) {
-  unsigned int program = glCreateProgram();
-  unsigned int vs = compile_shader(GL_VERTEX_SHADER, vertextShader);
-  unsigned int fs = compile_shader(GL_FRAGMENT_SHADER, fragmentShader);
-
-  GLCall(glAttachShader(program, vs));
-  GLCall(glAttachShader(program, fs));
-  GLCall(glLinkProgram(program));
-  GLCall(glValidateProgram(program));
-
-  GLCall(glDeleteShader(vs));
-  GLCall(glDeleteShader(fs));
-
-  return program;
-}
-
-int main(void) {
-  GLFWwindow* window;
-
-  if (!glfwInit()) {
-    fprintf(stderr, "Failed to initialize GLFW\n");
-    return -1;
-  }
-
-  glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
-  glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
-  glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
-
-  window = glfwCreateWindow(600, 400, "Hello World", NULL, NULL);
-
-  if (!window) {
-    fprintf(stderr, "Failed to create GLFW window\n");
-    glfwTerminate();
-    return -1;
+  if (bench) {
+    bool ran = bench_run(bench);
+    context_destroy(&context);
+    return ran ? 0 : -1;
   }
 
-  glfwMakeContextCurrent(window);
-
-  glfwSwapInterval(1);
-
-  // Initialize GLAD after creating OpenGL context
-  if (!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress)) {
-    fprintf(stderr, "Failed to initialize GLAD\n");
-    glfwTerminate();
+  const scene_t* scene = scene_find(scene_name);
+  void* state = scene ? scene->create() : NULL;
+  if (!state) {
+    context_destroy(&context);
     return -1;
   }
 
-  {  // create new scope to prevent GLError stuff.
-    float positions[] = {
-        -0.5f, -0.5f,  // bottom left
-        0.5f,  -0.5f,  // bottom right
-        0.5f,  0.5f,   // top right
-        -0.5f, 0.5f    // top left
-    };
-
-    unsigned int indicies[] = {0, 1, 2, 2, 3, 0};
-
-    vertex_array_t va = vertex_array_create();
-
-    vertex_buffer_t vb = vertex_buffer_create(positions, 4 * 2 * sizeof(float));
-
-    vertex_buffer_layout_t layout = vertex_buffer_layout_create();
-    vertex_buffer_layout_push_float(&layout, 2);  // x,y position
-
-    vertex_array_add_buffer(&va, &vb, &layout);
-
-    index_buffer_t ib = index_buffer_create(indicies, 6);
-
-    struct ShaderProgramSource source =
-        parse_shader("res/shaders/basic.shader");
-    unsigned int shader =
-        create_shader(source.VertexSource, source.FragmentSource);
-    GLCall(glUseProgram(shader));
-
-    GLCall(int location = glGetUniformLocation(shader, "u_Color"));
-    ASSERT(location != -1);
-    GLCall(glUniform4f(location, 1.0f, 0.5f, 0.3f, 1.0f));
+  printf("OpenGL Version: %s\n", glGetString(GL_VERSION));
 
-    // unbinding
-    vertex_array_unbind();
-    GLCall(glUseProgram(0));
-    vertex_buffer_unbind();
-    index_buffer_unbind();
+  double frame_min_ms = 1e9, frame_max_ms = 0.0;
+  double loop_start = timer_now();
 
-    float r = 0.0f;
-    float increment = 0.05f;
+  // Main render loop
+  while (!context_should_close(&context)) {
+    double frame_start = timer_now();
+    renderer_begin_frame();
+    GLCall(glClear(GL_COLOR_BUFFER_BIT));
 
-    printf("OpenGL Version: %s\n", glGetString(GL_VERSION));
+    scene->frame(state, context.frame);
 
-    // Main render loop
-    while (!glfwWindowShouldClose(window)) {
-      GLCall(glClear(GL_COLOR_BUFFER_BIT));
+    context_present(&context);
 
-      GLCall(glUseProgram(shader));
-      GLCall(glUniform4f(location, r, 0.5f, 0.3f, 1.0f));
-
-      vertex_array_bind(&va);
-      index_buffer_bind(&ib);
-
-      GLCall(glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, NULL));
+    double frame_ms = timer_elapsed_ms(frame_start);
+    if (frame_ms < frame_min_ms) frame_min_ms = frame_ms;
+    if (frame_ms > frame_max_ms) frame_max_ms = frame_ms;
+  }
 
-      if (r > 1.0f)
-        increment = -.05f;
-      else if (r < 0.0f)
-        increment = 0.05f;
+  if (context.frame > 0) {
+    double loop_ms = timer_elapsed_ms(loop_start);
+    printf("%u frames in %.1f ms: %.3f ms average, %.3f min, %.3f max\n",
+           context.frame, loop_ms, loop_ms / context.frame, frame_min_ms,
+           frame_max_ms);
+  }
 
-      r += increment;
+  bool matched = true;
+  if (context.backend == CONTEXT_BACKEND_HEADLESS) {
+    uint64_t checksum = context_checksum(&context);
+    printf("Image checksum: %016llx\n", (unsigned long long)checksum);
 
-      glfwSwapBuffers(window);
-      glfwPollEvents();
+    // A scene whose draws all went missing still passes a stability check
+    GLCall(glClear(GL_COLOR_BUFFER_BIT));
+    if (context_checksum(&context) == checksum) {
+      printf("Image is blank\n");
+      matched = false;
+    }
+    if (expect && strtoull(expect, NULL, 16) != checksum) {
+      printf("Expected checksum %s\n", expect);
+      matched = false;
     }
-
-    GLCall(glDeleteProgram(shader));
-    vertex_array_destroy(&va);
-    vertex_buffer_destroy(&vb);
-    index_buffer_destroy(&ib);
-    vertex_buffer_layout_destroy(&layout);
   }
-  glfwTerminate();
 
-  return 0;
+  renderer_stats_t stats = renderer_get_stats();
+  printf("Last frame: %u binds issued, %u elided\n", stats.binds_issued,
+         stats.binds_elided);
+  printf("Last frame: %u uniform uploads, %u elided\n", stats.uniform_uploads,
+         stats.uniform_uploads_elided);
+
+  scene->destroy(state);
+  context_destroy(&context);
+
+  return matched ? 0 : -1;
 }
\ No newline at end of file
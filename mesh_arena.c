@@ -0,0 +1,91 @@
+#include "mesh_arena.h"
+#include <stddef.h>
+#include "renderer.h"
+
+mesh_arena_t mesh_arena_create(unsigned int vertex_stride,
+                               unsigned int vertex_capacity,
+                               unsigned int index_capacity) {
+  mesh_arena_t arena;
+
+  arena.vertex_stride = vertex_stride;
+  arena.vertices = vertex_buffer_create_with_usage(
+      NULL, vertex_capacity * vertex_stride, BUFFER_USAGE_STATIC);
+  arena.indices = index_buffer_create_with_usage(NULL, index_capacity,
+                                                 BUFFER_USAGE_STATIC);
+  arena.vertex_ranges = range_allocator_create(vertex_capacity);
+  arena.index_ranges = range_allocator_create(index_capacity);
+
+  return arena;
+}
+
+void mesh_arena_destroy(mesh_arena_t* arena) {
+  if (arena) {
+    vertex_buffer_destroy(&arena->vertices);
+    index_buffer_destroy(&arena->indices);
+    range_allocator_destroy(&arena->vertex_ranges);
+    range_allocator_destroy(&arena->index_ranges);
+  }
+}
+
+// Allocate from ranges, growing it (and letting the caller grow the GL
+// buffer to match) when no free range is large enough
+static unsigned int alloc_growing(range_allocator_t* ranges,
+                                  unsigned int count) {
+  unsigned int offset = range_allocator_alloc(ranges, count);
+  if (offset != RANGE_ALLOCATOR_INVALID) return offset;
+
+  range_allocator_grow(ranges,
+                       gpu_buffer_grow_capacity(ranges->capacity,
+                                                ranges->capacity + count));
+  return range_allocator_alloc(ranges, count);
+}
+
+bool mesh_arena_alloc(mesh_arena_t* arena, const void* vertices,
+                      unsigned int vertex_count, const unsigned int* indices,
+                      unsigned int index_count, mesh_arena_mesh_t* mesh) {
+  unsigned int base_vertex = alloc_growing(&arena->vertex_ranges, vertex_count);
+  if (base_vertex == RANGE_ALLOCATOR_INVALID) return false;
+
+  unsigned int first_index = alloc_growing(&arena->index_ranges, index_count);
+  if (first_index == RANGE_ALLOCATOR_INVALID) {
+    range_allocator_free(&arena->vertex_ranges, base_vertex, vertex_count);
+    return false;
+  }
+
+  // Grows the GL buffers in place if the allocators grew
+  vertex_buffer_reserve(&arena->vertices,
+                        arena->vertex_ranges.capacity * arena->vertex_stride);
+  index_buffer_reserve(&arena->indices, arena->index_ranges.capacity);
+
+  vertex_buffer_update(&arena->vertices, base_vertex * arena->vertex_stride,
+                       vertices, vertex_count * arena->vertex_stride);
+  index_buffer_update(&arena->indices, first_index, indices, index_count);
+
+  mesh->base_vertex = base_vertex;
+  mesh->vertex_count = vertex_count;
+  mesh->first_index = first_index;
+  mesh->index_count = index_count;
+  return true;
+}
+
+void mesh_arena_free(mesh_arena_t* arena, const mesh_arena_mesh_t* mesh) {
+  range_allocator_free(&arena->vertex_ranges, mesh->base_vertex,
+                       mesh->vertex_count);
+  range_allocator_free(&arena->index_ranges, mesh->first_index,
+                       mesh->index_count);
+}
+
+void mesh_arena_draw(const mesh_arena_t* arena, const mesh_arena_mesh_t* mesh) {
+  unsigned int index_size = index_buffer_get_index_size(&arena->indices);
+  GLCall(glDrawElementsBaseVertex(
+      GL_TRIANGLES, mesh->index_count, index_buffer_get_type(&arena->indices),
+      (const void*)(size_t)(mesh->first_index * index_size),
+      mesh->base_vertex));
+}
+
+mesh_arena_stats_t mesh_arena_get_stats(const mesh_arena_t* arena) {
+  mesh_arena_stats_t stats;
+  stats.vertices = range_allocator_get_stats(&arena->vertex_ranges);
+  stats.indices = range_allocator_get_stats(&arena->index_ranges);
+  return stats;
+}
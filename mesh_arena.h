@@ -0,0 +1,50 @@
+#pragma once
+#include <stdbool.h>
+#include "index_buffer.h"
+#include "range_allocator.h"
+#include "vertex_buffer.h"
+
+// Where a mesh lives inside a mesh_arena. Indices are relative to the mesh's
+// own vertices, so draws pass base_vertex along with first_index, and the
+// shared index buffer stays 16-bit unless a single mesh needs more.
+typedef struct mesh_arena_mesh {
+  unsigned int base_vertex;
+  unsigned int vertex_count;
+  unsigned int first_index;
+  unsigned int index_count;
+} mesh_arena_mesh_t;
+
+typedef struct mesh_arena_stats {
+  range_allocator_stats_t vertices;  // In vertices
+  range_allocator_stats_t indices;   // In indices
+} mesh_arena_stats_t;
+
+// Packs many meshes of one vertex format into a shared vertex buffer and a
+// shared index buffer, so they can share a vertex array and be drawn
+// without rebinding. Both buffers grow in place when full.
+typedef struct mesh_arena {
+  vertex_buffer_t vertices;
+  index_buffer_t indices;
+  range_allocator_t vertex_ranges;
+  range_allocator_t index_ranges;
+  unsigned int vertex_stride;
+} mesh_arena_t;
+
+mesh_arena_t mesh_arena_create(unsigned int vertex_stride,
+                               unsigned int vertex_capacity,
+                               unsigned int index_capacity);
+void mesh_arena_destroy(mesh_arena_t* arena);
+
+// Copy a mesh into the arena. Returns false if it could not be placed.
+bool mesh_arena_alloc(mesh_arena_t* arena, const void* vertices,
+                      unsigned int vertex_count, const unsigned int* indices,
+                      unsigned int index_count, mesh_arena_mesh_t* mesh);
+
+// Release a mesh's ranges; neighbouring free ranges are coalesced
+void mesh_arena_free(mesh_arena_t* arena, const mesh_arena_mesh_t* mesh);
+
+// Draw one mesh. The vertex array describing the arena's buffers must be
+// bound.
+void mesh_arena_draw(const mesh_arena_t* arena, const mesh_arena_mesh_t* mesh);
+
+mesh_arena_stats_t mesh_arena_get_stats(const mesh_arena_t* arena);
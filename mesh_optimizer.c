@@ -0,0 +1,434 @@
+#include "mesh_optimizer.h"
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Forsyth's constants. The LRU he models is larger than the FIFO we
+// analyse with; ranking by recency still carries over well.
+#define FORSYTH_CACHE_SIZE 32
+#define FORSYTH_MAX_VALENCE 32  // Higher valences share the last boost
+#define CACHE_DECAY_POWER 1.5f
+#define LAST_TRIANGLE_SCORE 0.75f
+#define VALENCE_BOOST_SCALE 2.0f
+#define VALENCE_BOOST_POWER 0.5f
+
+#define NOT_IN_CACHE -1
+
+mesh_cache_stats_t mesh_analyze_vertex_cache(const unsigned int* indices,
+                                             unsigned int index_count,
+                                             unsigned int vertex_count,
+                                             unsigned int cache_size) {
+  mesh_cache_stats_t stats = {0, 0.0f, 0.0f};
+  if (!index_count || !vertex_count) return stats;
+
+  // A vertex is still cached if fewer than cache_size misses happened since
+  // it was last loaded
+  unsigned int* loaded_at =
+      (unsigned int*)calloc(vertex_count, sizeof(unsigned int));
+  unsigned char* referenced = (unsigned char*)calloc(vertex_count, 1);
+  unsigned int misses = 0;
+  unsigned int unique = 0;
+
+  for (unsigned int i = 0; i < index_count; i++) {
+    unsigned int v = indices[i];
+    if (v >= vertex_count) continue;
+
+    if (!referenced[v]) {
+      referenced[v] = 1;
+      unique++;
+    }
+    if (loaded_at[v] == 0 || misses - loaded_at[v] >= cache_size) {
+      misses++;
+      loaded_at[v] = misses;  // 1-based so 0 means never loaded
+    }
+  }
+
+  stats.vertices_transformed = misses;
+  stats.acmr = (float)misses / (float)(index_count / 3);
+  stats.atvr = unique ? (float)misses / (float)unique : 0.0f;
+
+  free(loaded_at);
+  free(referenced);
+  return stats;
+}
+
+static float cache_score_table[FORSYTH_CACHE_SIZE];
+static float valence_score_table[FORSYTH_MAX_VALENCE + 1];
+static int score_tables_ready = 0;
+
+static void build_score_tables(void) {
+  for (int i = 0; i < FORSYTH_CACHE_SIZE; i++) {
+    if (i < 3) {
+      // Vertices of the triangle just emitted: deliberately not the
+      // highest score, so the next triangle does not always reuse them
+      cache_score_table[i] = LAST_TRIANGLE_SCORE;
+    } else {
+      float scale = 1.0f / (FORSYTH_CACHE_SIZE - 3);
+      cache_score_table[i] =
+          powf(1.0f - (i - 3) * scale, CACHE_DECAY_POWER);
+    }
+  }
+
+  valence_score_table[0] = 0.0f;
+  for (int i = 1; i <= FORSYTH_MAX_VALENCE; i++) {
+    // Few remaining triangles: finish the vertex off to avoid stragglers
+    valence_score_table[i] =
+        VALENCE_BOOST_SCALE * powf((float)i, -VALENCE_BOOST_POWER);
+  }
+  score_tables_ready = 1;
+}
+
+static float vertex_score(int cache_position, unsigned int valence) {
+  if (valence == 0) return -1.0f;  // No triangles left to draw with it
+
+  float score = 0.0f;
+  if (cache_position >= 0) score = cache_score_table[cache_position];
+  if (valence > FORSYTH_MAX_VALENCE) valence = FORSYTH_MAX_VALENCE;
+  return score + valence_score_table[valence];
+}
+
+void mesh_optimize_vertex_cache(unsigned int* dst, const unsigned int* indices,
+                                unsigned int index_count,
+                                unsigned int vertex_count) {
+  unsigned int triangle_count = index_count / 3;
+  if (!triangle_count) return;
+  if (!score_tables_ready) build_score_tables();
+
+  // Per-vertex list of triangles not yet emitted. The first valence[v]
+  // entries of v's slice are the live ones.
+  unsigned int* valence =
+      (unsigned int*)calloc(vertex_count, sizeof(unsigned int));
+  unsigned int* first_triangle =
+      (unsigned int*)malloc((vertex_count + 1) * sizeof(unsigned int));
+  unsigned int* adjacency =
+      (unsigned int*)malloc(triangle_count * 3 * sizeof(unsigned int));
+  int* cache_position = (int*)malloc(vertex_count * sizeof(int));
+  float* score = (float*)malloc(vertex_count * sizeof(float));
+  float* triangle_score = (float*)malloc(triangle_count * sizeof(float));
+  unsigned char* emitted = (unsigned char*)calloc(triangle_count, 1);
+
+  for (unsigned int i = 0; i < triangle_count * 3; i++) valence[indices[i]]++;
+
+  unsigned int offset = 0;
+  for (unsigned int v = 0; v < vertex_count; v++) {
+    first_triangle[v] = offset;
+    offset += valence[v];
+    valence[v] = 0;
+  }
+  first_triangle[vertex_count] = offset;
+
+  for (unsigned int t = 0; t < triangle_count; t++) {
+    for (int k = 0; k < 3; k++) {
+      unsigned int v = indices[t * 3 + k];
+      adjacency[first_triangle[v] + valence[v]++] = t;
+    }
+  }
+
+  for (unsigned int v = 0; v < vertex_count; v++) {
+    cache_position[v] = NOT_IN_CACHE;
+    score[v] = vertex_score(NOT_IN_CACHE, valence[v]);
+  }
+
+  unsigned int best_triangle = 0;
+  float best_score = -1.0f;
+  for (unsigned int t = 0; t < triangle_count; t++) {
+    const unsigned int* tri = &indices[t * 3];
+    triangle_score[t] = score[tri[0]] + score[tri[1]] + score[tri[2]];
+    if (triangle_score[t] > best_score) {
+      best_score = triangle_score[t];
+      best_triangle = t;
+    }
+  }
+
+  // Room for the cache plus the three vertices pushed in front of it
+  unsigned int cache[FORSYTH_CACHE_SIZE + 3];
+  unsigned int cache_count = 0;
+  unsigned int scan_cursor = 0;  // Fallback search resumes here
+
+  for (unsigned int emitted_count = 0; emitted_count < triangle_count;
+       emitted_count++) {
+    if (best_score < 0.0f) {
+      // Nothing adjacent to the cache is left; take the next unemitted
+      // triangle in input order. The cursor only moves forward, keeping
+      // the whole pass linear.
+      while (emitted[scan_cursor]) scan_cursor++;
+      best_triangle = scan_cursor;
+    }
+
+    const unsigned int* tri = &indices[best_triangle * 3];
+    memcpy(&dst[emitted_count * 3], tri, 3 * sizeof(unsigned int));
+    emitted[best_triangle] = 1;
+
+    // Drop the triangle from its vertices' live lists
+    for (int k = 0; k < 3; k++) {
+      unsigned int v = tri[k];
+      unsigned int* list = &adjacency[first_triangle[v]];
+      for (unsigned int i = 0; i < valence[v]; i++) {
+        if (list[i] == best_triangle) {
+          list[i] = list[--valence[v]];
+          break;
+        }
+      }
+    }
+
+    // New cache: the triangle's vertices first, then the old cache minus
+    // them. Entries past FORSYTH_CACHE_SIZE fall out.
+    unsigned int new_cache[FORSYTH_CACHE_SIZE + 3];
+    unsigned int new_count = 0;
+    for (int k = 0; k < 3; k++) new_cache[new_count++] = tri[k];
+    for (unsigned int i = 0; i < cache_count; i++) {
+      unsigned int v = cache[i];
+      if (v != tri[0] && v != tri[1] && v != tri[2]) {
+        new_cache[new_count++] = v;
+      }
+    }
+
+    for (unsigned int i = 0; i < new_count; i++) {
+      unsigned int v = new_cache[i];
+      cache_position[v] = i < FORSYTH_CACHE_SIZE ? (int)i : NOT_IN_CACHE;
+      float new_score = vertex_score(cache_position[v], valence[v]);
+      float delta = new_score - score[v];
+      score[v] = new_score;
+
+      const unsigned int* list = &adjacency[first_triangle[v]];
+      for (unsigned int j = 0; j < valence[v]; j++) {
+        triangle_score[list[j]] += delta;
+      }
+    }
+
+    // Only triangles touching the cache changed, so the next pick is one
+    // of them. Scored in a second pass since a triangle can receive deltas
+    // from up to three cache vertices.
+    best_score = -1.0f;
+    for (unsigned int i = 0; i < new_count; i++) {
+      unsigned int v = new_cache[i];
+      const unsigned int* list = &adjacency[first_triangle[v]];
+      for (unsigned int j = 0; j < valence[v]; j++) {
+        unsigned int t = list[j];
+        if (triangle_score[t] > best_score) {
+          best_score = triangle_score[t];
+          best_triangle = t;
+        }
+      }
+    }
+
+    cache_count =
+        new_count < FORSYTH_CACHE_SIZE ? new_count : FORSYTH_CACHE_SIZE;
+    memcpy(cache, new_cache, cache_count * sizeof(unsigned int));
+  }
+
+  free(valence);
+  free(first_triangle);
+  free(adjacency);
+  free(cache_position);
+  free(score);
+  free(triangle_score);
+  free(emitted);
+}
+
+unsigned int mesh_optimize_vertex_fetch(void* dst_vertices,
+                                        unsigned int* indices,
+                                        unsigned int index_count,
+                                        const void* vertices,
+                                        unsigned int vertex_count,
+                                        unsigned int stride) {
+  unsigned int* remap =
+      (unsigned int*)malloc(vertex_count * sizeof(unsigned int));
+  memset(remap, 0xFF, vertex_count * sizeof(unsigned int));
+
+  unsigned char* dst = (unsigned char*)dst_vertices;
+  const unsigned char* src = (const unsigned char*)vertices;
+  unsigned int next = 0;
+
+  for (unsigned int i = 0; i < index_count; i++) {
+    unsigned int v = indices[i];
+    if (remap[v] == 0xFFFFFFFFu) {
+      memcpy(dst + (size_t)next * stride, src + (size_t)v * stride, stride);
+      remap[v] = next++;
+    }
+    indices[i] = remap[v];
+  }
+
+  free(remap);
+  return next;
+}
+
+typedef struct overdraw_cluster {
+  unsigned int first_triangle;
+  unsigned int triangle_count;
+  float sort_key;
+} overdraw_cluster_t;
+
+// FIFO cache simulation shared by the cluster passes. Bumping the clock by
+// more than the cache size empties it.
+typedef struct cache_sim {
+  unsigned int* loaded_at;
+  unsigned int clock;
+  unsigned int size;
+} cache_sim_t;
+
+static unsigned int cache_sim_triangle(cache_sim_t* sim,
+                                       const unsigned int* tri) {
+  unsigned int misses = 0;
+  for (int k = 0; k < 3; k++) {
+    unsigned int v = tri[k];
+    if (sim->loaded_at[v] == 0 || sim->clock - sim->loaded_at[v] >= sim->size) {
+      sim->clock++;
+      sim->loaded_at[v] = sim->clock;
+      misses++;
+    }
+  }
+  return misses;
+}
+
+static void cache_sim_flush(cache_sim_t* sim) { sim->clock += sim->size + 1; }
+
+static const float* vertex_position(const float* positions,
+                                    unsigned int stride, unsigned int v) {
+  return (const float*)((const unsigned char*)positions + (size_t)v * stride);
+}
+
+static int compare_clusters(const void* a, const void* b) {
+  const overdraw_cluster_t* ca = (const overdraw_cluster_t*)a;
+  const overdraw_cluster_t* cb = (const overdraw_cluster_t*)b;
+  if (ca->sort_key != cb->sort_key) return ca->sort_key > cb->sort_key ? -1 : 1;
+  // Keep the original order for ties so the result is deterministic
+  return ca->first_triangle < cb->first_triangle ? -1 : 1;
+}
+
+void mesh_optimize_overdraw(unsigned int* dst, const unsigned int* indices,
+                            unsigned int index_count, const float* positions,
+                            unsigned int vertex_count,
+                            unsigned int position_stride, float threshold) {
+  unsigned int triangle_count = index_count / 3;
+  if (!triangle_count) return;
+
+  cache_sim_t sim;
+  sim.loaded_at = (unsigned int*)calloc(vertex_count, sizeof(unsigned int));
+  sim.clock = 0;
+  sim.size = MESH_OPTIMIZER_CACHE_SIZE;
+
+  // Hard boundaries: triangles where all three vertices miss, i.e. the
+  // cache order already restarts there, so cutting costs nothing
+  unsigned int* hard = (unsigned int*)malloc((triangle_count + 1) *
+                                             sizeof(unsigned int));
+  unsigned int hard_count = 0;
+  for (unsigned int t = 0; t < triangle_count; t++) {
+    if (cache_sim_triangle(&sim, &indices[t * 3]) == 3) hard[hard_count++] = t;
+  }
+  if (hard_count == 0 || hard[0] != 0) {
+    // The first triangle always misses, but be safe with odd input
+    memmove(hard + 1, hard, hard_count * sizeof(unsigned int));
+    hard[0] = 0;
+    hard_count++;
+  }
+  hard[hard_count] = triangle_count;
+
+  // Soft boundaries: inside each hard cluster, cut as soon as the
+  // sub-cluster's ACMR (starting from an empty cache) is within threshold
+  // of the whole cluster's
+  overdraw_cluster_t* clusters = (overdraw_cluster_t*)malloc(
+      triangle_count * sizeof(overdraw_cluster_t));
+  unsigned int cluster_count = 0;
+
+  for (unsigned int h = 0; h < hard_count; h++) {
+    unsigned int start = hard[h];
+    unsigned int end = hard[h + 1];
+
+    cache_sim_flush(&sim);
+    unsigned int cluster_misses = 0;
+    for (unsigned int t = start; t < end; t++)
+      cluster_misses += cache_sim_triangle(&sim, &indices[t * 3]);
+    float cluster_acmr = (float)cluster_misses / (float)(end - start);
+    float target = cluster_acmr * threshold;
+
+    cache_sim_flush(&sim);
+    unsigned int sub_start = start;
+    unsigned int sub_misses = 0;
+    for (unsigned int t = start; t < end; t++) {
+      sub_misses += cache_sim_triangle(&sim, &indices[t * 3]);
+      float acmr = (float)sub_misses / (float)(t - sub_start + 1);
+      if (acmr <= target || t + 1 == end) {
+        clusters[cluster_count].first_triangle = sub_start;
+        clusters[cluster_count].triangle_count = t + 1 - sub_start;
+        cluster_count++;
+        sub_start = t + 1;
+        sub_misses = 0;
+        cache_sim_flush(&sim);
+      }
+    }
+  }
+
+  // Mesh centroid, area weighted
+  float mesh_center[3] = {0.0f, 0.0f, 0.0f};
+  float mesh_area = 0.0f;
+  // Per triangle: centre, normal scaled by area, area
+  float* triangle_data = (float*)malloc(triangle_count * 7 * sizeof(float));
+  for (unsigned int t = 0; t < triangle_count; t++) {
+    const float* a =
+        vertex_position(positions, position_stride, indices[t * 3]);
+    const float* b =
+        vertex_position(positions, position_stride, indices[t * 3 + 1]);
+    const float* c =
+        vertex_position(positions, position_stride, indices[t * 3 + 2]);
+    float e1[3] = {b[0] - a[0], b[1] - a[1], b[2] - a[2]};
+    float e2[3] = {c[0] - a[0], c[1] - a[1], c[2] - a[2]};
+    float n[3] = {e1[1] * e2[2] - e1[2] * e2[1], e1[2] * e2[0] - e1[0] * e2[2],
+                  e1[0] * e2[1] - e1[1] * e2[0]};
+    float area = sqrtf(n[0] * n[0] + n[1] * n[1] + n[2] * n[2]) * 0.5f;
+
+    float* data = &triangle_data[t * 7];
+    for (int k = 0; k < 3; k++) {
+      data[k] = (a[k] + b[k] + c[k]) / 3.0f;
+      data[3 + k] = n[k] * 0.5f;  // Unnormalized: length is the area
+      mesh_center[k] += data[k] * area;
+    }
+    data[6] = area;
+    mesh_area += area;
+  }
+  if (mesh_area > 0.0f) {
+    for (int k = 0; k < 3; k++) mesh_center[k] /= mesh_area;
+  }
+
+  // Occlusion potential: how far the cluster sits out from the centre
+  // along its own average normal
+  for (unsigned int c = 0; c < cluster_count; c++) {
+    float center[3] = {0.0f, 0.0f, 0.0f};
+    float normal[3] = {0.0f, 0.0f, 0.0f};
+    float area = 0.0f;
+    unsigned int first = clusters[c].first_triangle;
+    for (unsigned int t = first; t < first + clusters[c].triangle_count; t++) {
+      const float* data = &triangle_data[t * 7];
+      for (int k = 0; k < 3; k++) {
+        center[k] += data[k] * data[6];
+        normal[k] += data[3 + k];
+      }
+      area += data[6];
+    }
+
+    float length = sqrtf(normal[0] * normal[0] + normal[1] * normal[1] +
+                         normal[2] * normal[2]);
+    float key = 0.0f;
+    if (area > 0.0f && length > 0.0f) {
+      for (int k = 0; k < 3; k++) {
+        key += (center[k] / area - mesh_center[k]) * (normal[k] / length);
+      }
+    }
+    clusters[c].sort_key = key;
+  }
+
+  qsort(clusters, cluster_count, sizeof(overdraw_cluster_t), compare_clusters);
+
+  unsigned int written = 0;
+  for (unsigned int c = 0; c < cluster_count; c++) {
+    unsigned int count = clusters[c].triangle_count * 3;
+    memcpy(&dst[written], &indices[clusters[c].first_triangle * 3],
+           count * sizeof(unsigned int));
+    written += count;
+  }
+
+  free(sim.loaded_at);
+  free(hard);
+  free(clusters);
+  free(triangle_data);
+}
@@ -0,0 +1,53 @@
+#pragma once
+
+// CPU-side passes over triangle lists (3 indices per triangle). They only
+// touch memory, so they can run at load time or in an offline asset step
+// before the data reaches index_buffer_create / vertex_buffer_create.
+
+// Post-transform cache size the optimizers target and the analysis
+// simulates. Small enough to be pessimistic for current desktop GPUs.
+#define MESH_OPTIMIZER_CACHE_SIZE 16
+
+typedef struct mesh_cache_stats {
+  unsigned int vertices_transformed;  // Cache misses in the simulated FIFO
+  float acmr;  // Average cache miss ratio: transformed per triangle, 0.5-3
+  float atvr;  // Transformed per referenced vertex, 1.0 is optimal
+} mesh_cache_stats_t;
+
+// Simulate a FIFO post-transform cache of cache_size entries over the
+// index stream
+mesh_cache_stats_t mesh_analyze_vertex_cache(const unsigned int* indices,
+                                             unsigned int index_count,
+                                             unsigned int vertex_count,
+                                             unsigned int cache_size);
+
+// Reorder triangles for post-transform cache locality using Tom Forsyth's
+// linear-speed greedy scoring. dst and indices may not alias.
+void mesh_optimize_vertex_cache(unsigned int* dst, const unsigned int* indices,
+                                unsigned int index_count,
+                                unsigned int vertex_count);
+
+// Reorder vertices into the order the index stream first fetches them and
+// remap indices in place, so vertex fetch walks memory forward. Vertices no
+// triangle references are dropped. dst_vertices must hold vertex_count *
+// stride bytes and may not alias vertices. Returns the new vertex count.
+unsigned int mesh_optimize_vertex_fetch(void* dst_vertices,
+                                        unsigned int* indices,
+                                        unsigned int index_count,
+                                        const void* vertices,
+                                        unsigned int vertex_count,
+                                        unsigned int stride);
+
+// Reorder triangles to reduce overdraw while keeping most of the vertex
+// cache order (run mesh_optimize_vertex_cache first). The index stream is
+// cut into clusters wherever the simulated cache restarts or the local
+// ACMR stays within threshold times the cluster's, then clusters are
+// drawn in order of view-independent occlusion potential: those facing
+// away from the mesh centre, which tend to cover the rest, go first.
+// threshold is the accepted ACMR degradation, e.g. 1.05 for 5%; higher
+// values give more, smaller clusters and less overdraw. positions points
+// at the first vertex's xyz floats, position_stride is in bytes.
+void mesh_optimize_overdraw(unsigned int* dst, const unsigned int* indices,
+                            unsigned int index_count, const float* positions,
+                            unsigned int vertex_count,
+                            unsigned int position_stride, float threshold);
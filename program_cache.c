@@ -0,0 +1,264 @@
+#include "program_cache.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "gl_ext.h"
+#include "hash.h"
+#include "renderer.h"
+#include "shader.h"
+#include "timer.h"
+
+#if defined(_WIN32)
+#include <direct.h>
+#define make_directory(path) _mkdir(path)
+#else
+#include <sys/stat.h>
+#define make_directory(path) mkdir(path, 0755)
+#endif
+
+#define CACHE_MAGIC 0x42505950u  // "PYPB"
+#define CACHE_VERSION 1u
+
+typedef struct cache_header {
+  uint32_t magic;
+  uint32_t version;
+  uint64_t key;
+  uint32_t binary_format;
+  uint32_t binary_length;
+  double build_ms;  // Source build time, used to report time saved on a hit
+} cache_header_t;
+
+static char* copy_string(const char* string) {
+  size_t length = strlen(string);
+  char* copy = (char*)malloc(length + 1);
+  memcpy(copy, string, length + 1);
+  return copy;
+}
+
+static void cache_path(const program_cache_t* cache, uint64_t key, char* path,
+                       size_t size) {
+  snprintf(path, size, "%s/%016llx.bin", cache->directory,
+           (unsigned long long)key);
+}
+
+program_cache_t program_cache_create(const char* directory) {
+  program_cache_t cache;
+  memset(&cache, 0, sizeof(cache));
+
+  cache.directory = copy_string(directory);
+  cache.enabled = gl_ext.program_binary;
+
+  uint64_t hash = HASH_SEED;
+  hash = hash_string((const char*)glGetString(GL_VENDOR), hash);
+  hash = hash_string((const char*)glGetString(GL_RENDERER), hash);
+  hash = hash_string((const char*)glGetString(GL_VERSION), hash);
+  cache.context_hash = hash;
+
+  if (cache.enabled) {
+    GLCall(glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS,
+                         &cache.binary_format_count));
+    cache.binary_formats =
+        (int*)malloc(cache.binary_format_count * sizeof(int));
+    GLCall(glGetIntegerv(GL_PROGRAM_BINARY_FORMATS, cache.binary_formats));
+    make_directory(directory);  // Fails harmlessly if present
+  }
+
+  return cache;
+}
+
+void program_cache_destroy(program_cache_t* cache) {
+  if (cache) {
+    free(cache->directory);
+    free(cache->binary_formats);
+    cache->directory = NULL;
+    cache->binary_formats = NULL;
+    cache->binary_format_count = 0;
+    cache->enabled = false;
+  }
+}
+
+uint64_t program_cache_key(const program_cache_t* cache,
+                           const shader_source_t* source) {
+  uint64_t hash = cache->context_hash;
+  for (unsigned int i = 0; i < source->stage_count; i++) {
+    const shader_stage_source_t* stage = &source->stages[i];
+    uint32_t type = (uint32_t)stage->stage;
+    uint32_t length = stage->length;
+    hash = hash_bytes(&type, sizeof(type), hash);
+    hash = hash_bytes(&length, sizeof(length), hash);
+    hash = hash_bytes(stage->source, stage->length, hash);
+  }
+  return hash;
+}
+
+void program_cache_evict(const program_cache_t* cache,
+                         const shader_source_t* source) {
+  if (!cache->enabled) return;
+
+  char path[1024];
+  cache_path(cache, program_cache_key(cache, source), path, sizeof(path));
+  remove(path);  // Fails harmlessly if nothing was stored
+}
+
+static bool supports_format(const program_cache_t* cache, uint32_t format) {
+  for (int i = 0; i < cache->binary_format_count; i++) {
+    if ((uint32_t)cache->binary_formats[i] == format) return true;
+  }
+  return false;
+}
+
+static unsigned int load_binary(program_cache_t* cache, uint64_t key,
+                                double* build_ms) {
+  char path[1024];
+  cache_path(cache, key, path, sizeof(path));
+
+  FILE* file = fopen(path, "rb");
+  if (!file) return 0;
+
+  cache_header_t header;
+  void* binary = NULL;
+  unsigned int program = 0;
+
+  if (fread(&header, sizeof(header), 1, file) == 1 &&
+      header.magic == CACHE_MAGIC && header.version == CACHE_VERSION &&
+      header.key == key && header.binary_length > 0 &&
+      supports_format(cache, header.binary_format)) {
+    binary = malloc(header.binary_length);
+    if (fread(binary, 1, header.binary_length, file) == header.binary_length) {
+      // The format was checked above, since an unknown one raises
+      // GL_INVALID_ENUM, which the debug callback treats as a bug. A binary
+      // in a known format that a driver update or a different GPU no
+      // longer accepts only fails the link status and falls back to
+      // compiling.
+      program = glCreateProgram();
+      GLCall(glProgramBinary(program, header.binary_format, binary,
+                             (GLsizei)header.binary_length));
+
+      int status = GL_FALSE;
+      GLCall(glGetProgramiv(program, GL_LINK_STATUS, &status));
+      if (status == GL_FALSE) {
+        GLCall(glDeleteProgram(program));
+        program = 0;
+      }
+      *build_ms = header.build_ms;
+    }
+  }
+
+  free(binary);
+  fclose(file);
+  return program;
+}
+
+static void store_binary(program_cache_t* cache, uint64_t key,
+                         unsigned int program, double build_ms) {
+  int length = 0;
+  GLCall(glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length));
+  if (length <= 0) return;
+
+  cache_header_t header;
+  memset(&header, 0, sizeof(header));
+  header.magic = CACHE_MAGIC;
+  header.version = CACHE_VERSION;
+  header.key = key;
+  header.build_ms = build_ms;
+
+  void* binary = malloc(length);
+  GLenum format = 0;
+  GLsizei written = 0;
+  GLCall(glGetProgramBinary(program, length, &written, &format, binary));
+  header.binary_format = format;
+  header.binary_length = (uint32_t)written;
+
+  char path[1024];
+  cache_path(cache, key, path, sizeof(path));
+
+  FILE* file = written > 0 ? fopen(path, "wb") : NULL;
+  if (file) {
+    fwrite(&header, sizeof(header), 1, file);
+    fwrite(binary, 1, written, file);
+    fclose(file);
+  }
+
+  free(binary);
+}
+
+program_cache_build_t program_cache_begin(program_cache_t* cache,
+                                          const shader_source_t* source) {
+  program_cache_build_t result;
+  memset(&result, 0, sizeof(result));
+  result.start_time = timer_now();
+
+  if (cache->enabled) {
+    result.key = program_cache_key(cache, source);
+
+    double recorded_build_ms = 0.0;
+    unsigned int program = load_binary(cache, result.key, &recorded_build_ms);
+    if (program) {
+      double load_ms = timer_elapsed_ms(result.start_time);
+      cache->stats.hits++;
+      cache->stats.load_ms += load_ms;
+      if (recorded_build_ms > load_ms)
+        cache->stats.saved_ms += recorded_build_ms - load_ms;
+
+      result.build.program = program;
+      result.build.finished = true;
+      result.build.linked = true;
+      result.from_cache = true;
+      return result;
+    }
+  }
+
+  cache->stats.misses++;
+
+  unsigned int program = glCreateProgram();
+  if (cache->enabled) {
+    GLCall(glProgramParameteri(program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT,
+                               GL_TRUE));
+  }
+  result.build = shader_build_begin(program, source);
+  return result;
+}
+
+bool program_cache_ready(const program_cache_build_t* build) {
+  return shader_build_ready(&build->build);
+}
+
+unsigned int program_cache_finish(program_cache_t* cache,
+                                  program_cache_build_t* build) {
+  if (build->from_cache) return build->build.program;
+  if (build->build.finished && !build->build.linked) return 0;
+
+  bool waited = !build->build.finished;
+  if (!shader_build_finish(&build->build)) {
+    GLCall(glDeleteProgram(build->build.program));
+    build->build.program = 0;
+    return 0;
+  }
+
+  if (waited) {
+    // Wall time from submission, which overlaps whatever the caller did in
+    // between. It is only an upper bound on the driver's compile time.
+    double build_ms = timer_elapsed_ms(build->start_time);
+    cache->stats.build_ms += build_ms;
+    if (cache->enabled) {
+      store_binary(cache, build->key, build->build.program, build_ms);
+    }
+  }
+
+  return build->build.program;
+}
+
+unsigned int program_cache_get(program_cache_t* cache,
+                               const shader_source_t* source) {
+  program_cache_build_t build = program_cache_begin(cache, source);
+  return program_cache_finish(cache, &build);
+}
+
+void program_cache_print_stats(const program_cache_t* cache) {
+  const program_cache_stats_t* stats = &cache->stats;
+  printf(
+      "Program cache: %u hits, %u misses, %.2f ms building, %.2f ms loading, "
+      "%.2f ms saved%s\n",
+      stats->hits, stats->misses, stats->build_ms, stats->load_ms,
+      stats->saved_ms, cache->enabled ? "" : " (no binary formats)");
+}
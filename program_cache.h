@@ -0,0 +1,66 @@
+#pragma once
+#include <stdbool.h>
+#include <stdint.h>
+#include "shader.h"
+#include "shader_source.h"
+
+typedef struct program_cache_stats {
+  unsigned int hits;
+  unsigned int misses;  // Includes binaries the driver rejected
+  double build_ms;      // Time spent compiling and linking from source
+  double load_ms;       // Time spent loading cached binaries
+  double saved_ms;      // Recorded build time of hits minus their load time
+} program_cache_stats_t;
+
+typedef struct program_cache {
+  char* directory;
+  uint64_t context_hash;  // GL vendor, renderer and version strings
+  bool enabled;           // False when the context has no binary formats
+  int* binary_formats;    // GL_PROGRAM_BINARY_FORMATS of the context
+  int binary_format_count;
+  program_cache_stats_t stats;
+} program_cache_t;
+
+// A program being fetched from the cache or built from source
+typedef struct program_cache_build {
+  shader_build_t build;
+  uint64_t key;
+  double start_time;
+  bool from_cache;
+} program_cache_build_t;
+
+// Create a cache storing binaries in directory (created if missing). Must be
+// called with the GL context current, after gl_ext_load.
+program_cache_t program_cache_create(const char* directory);
+
+void program_cache_destroy(program_cache_t* cache);
+
+// Key for a program: stage types and sources plus the context hash
+uint64_t program_cache_key(const program_cache_t* cache,
+                           const shader_source_t* source);
+
+// Delete the stored binary for source, if any, so the next fetch builds
+// from source again
+void program_cache_evict(const program_cache_t* cache,
+                         const shader_source_t* source);
+
+// Start fetching a program for source. A cached binary the driver accepts
+// is restored immediately; otherwise a source build is started without
+// waiting for it, so many programs can be submitted up front.
+program_cache_build_t program_cache_begin(program_cache_t* cache,
+                                          const shader_source_t* source);
+
+// Whether program_cache_finish would return without blocking
+bool program_cache_ready(const program_cache_build_t* build);
+
+// Wait for the program, storing its binary if it was built from source.
+// Returns the linked program, or 0 on failure.
+unsigned int program_cache_finish(program_cache_t* cache,
+                                  program_cache_build_t* build);
+
+// Begin and finish in one call
+unsigned int program_cache_get(program_cache_t* cache,
+                               const shader_source_t* source);
+
+// Print hit/miss counts and time saved
+void program_cache_print_stats(const program_cache_t* cache);
@@ -0,0 +1,163 @@
+#include "range_allocator.h"
+#include <stdlib.h>
+#include <string.h>
+
+#define INITIAL_CAPACITY 16
+
+static void ensure_capacity(range_allocator_t* allocator) {
+  if (allocator->free_count >= allocator->free_capacity) {
+    allocator->free_capacity *= 2;
+    allocator->free_blocks = (range_block_t*)realloc(
+        allocator->free_blocks,
+        allocator->free_capacity * sizeof(range_block_t));
+  }
+}
+
+static void insert_block(range_allocator_t* allocator, unsigned int index,
+                         unsigned int offset, unsigned int size) {
+  ensure_capacity(allocator);
+  memmove(&allocator->free_blocks[index + 1], &allocator->free_blocks[index],
+          (allocator->free_count - index) * sizeof(range_block_t));
+  allocator->free_blocks[index].offset = offset;
+  allocator->free_blocks[index].size = size;
+  allocator->free_count++;
+}
+
+static void remove_block(range_allocator_t* allocator, unsigned int index) {
+  memmove(&allocator->free_blocks[index], &allocator->free_blocks[index + 1],
+          (allocator->free_count - index - 1) * sizeof(range_block_t));
+  allocator->free_count--;
+}
+
+range_allocator_t range_allocator_create(unsigned int capacity) {
+  range_allocator_t allocator;
+
+  allocator.free_blocks =
+      (range_block_t*)malloc(INITIAL_CAPACITY * sizeof(range_block_t));
+  allocator.free_count = 0;
+  allocator.free_capacity = INITIAL_CAPACITY;
+  allocator.capacity = capacity;
+  allocator.used = 0;
+  allocator.allocations = 0;
+
+  if (capacity > 0) insert_block(&allocator, 0, 0, capacity);
+
+  return allocator;
+}
+
+void range_allocator_destroy(range_allocator_t* allocator) {
+  if (allocator && allocator->free_blocks) {
+    free(allocator->free_blocks);
+    allocator->free_blocks = NULL;
+    allocator->free_count = 0;
+    allocator->free_capacity = 0;
+    allocator->capacity = 0;
+    allocator->used = 0;
+    allocator->allocations = 0;
+  }
+}
+
+unsigned int range_allocator_alloc(range_allocator_t* allocator,
+                                   unsigned int size) {
+  if (!size) return RANGE_ALLOCATOR_INVALID;
+
+  unsigned int best = RANGE_ALLOCATOR_INVALID;
+  for (unsigned int i = 0; i < allocator->free_count; i++) {
+    unsigned int block_size = allocator->free_blocks[i].size;
+    if (block_size < size) continue;
+    if (best == RANGE_ALLOCATOR_INVALID ||
+        block_size < allocator->free_blocks[best].size) {
+      best = i;
+      if (block_size == size) break;
+    }
+  }
+  if (best == RANGE_ALLOCATOR_INVALID) return RANGE_ALLOCATOR_INVALID;
+
+  range_block_t* block = &allocator->free_blocks[best];
+  unsigned int offset = block->offset;
+  if (block->size == size) {
+    remove_block(allocator, best);
+  } else {
+    block->offset += size;
+    block->size -= size;
+  }
+
+  allocator->used += size;
+  allocator->allocations++;
+  return offset;
+}
+
+void range_allocator_free(range_allocator_t* allocator, unsigned int offset,
+                          unsigned int size) {
+  if (offset == RANGE_ALLOCATOR_INVALID || !size) return;
+
+  // First free block after the range
+  unsigned int low = 0, high = allocator->free_count;
+  while (low < high) {
+    unsigned int mid = (low + high) / 2;
+    if (allocator->free_blocks[mid].offset < offset) {
+      low = mid + 1;
+    } else {
+      high = mid;
+    }
+  }
+
+  range_block_t* prev = low > 0 ? &allocator->free_blocks[low - 1] : NULL;
+  range_block_t* next =
+      low < allocator->free_count ? &allocator->free_blocks[low] : NULL;
+  int merges_prev = prev && prev->offset + prev->size == offset;
+  int merges_next = next && offset + size == next->offset;
+
+  if (merges_prev && merges_next) {
+    prev->size += size + next->size;
+    remove_block(allocator, low);
+  } else if (merges_prev) {
+    prev->size += size;
+  } else if (merges_next) {
+    next->offset = offset;
+    next->size += size;
+  } else {
+    insert_block(allocator, low, offset, size);
+  }
+
+  allocator->used -= size;
+  allocator->allocations--;
+}
+
+void range_allocator_grow(range_allocator_t* allocator,
+                          unsigned int new_capacity) {
+  if (new_capacity <= allocator->capacity) return;
+
+  unsigned int added = new_capacity - allocator->capacity;
+  range_block_t* last =
+      allocator->free_count
+          ? &allocator->free_blocks[allocator->free_count - 1]
+          : NULL;
+
+  if (last && last->offset + last->size == allocator->capacity) {
+    last->size += added;
+  } else {
+    insert_block(allocator, allocator->free_count, allocator->capacity, added);
+  }
+  allocator->capacity = new_capacity;
+}
+
+range_allocator_stats_t range_allocator_get_stats(
+    const range_allocator_t* allocator) {
+  range_allocator_stats_t stats;
+  stats.capacity = allocator->capacity;
+  stats.used = allocator->used;
+  stats.allocations = allocator->allocations;
+  stats.free_blocks = allocator->free_count;
+  stats.largest_free_block = 0;
+
+  for (unsigned int i = 0; i < allocator->free_count; i++) {
+    if (allocator->free_blocks[i].size > stats.largest_free_block)
+      stats.largest_free_block = allocator->free_blocks[i].size;
+  }
+
+  unsigned int free_space = allocator->capacity - allocator->used;
+  stats.fragmentation =
+      free_space ? 1.0f - (float)stats.largest_free_block / free_space : 0.0f;
+  return stats;
+}
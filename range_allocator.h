@@ -0,0 +1,49 @@
+#pragma once
+
+#define RANGE_ALLOCATOR_INVALID 0xFFFFFFFFu
+
+typedef struct range_block {
+  unsigned int offset;
+  unsigned int size;
+} range_block_t;
+
+typedef struct range_allocator_stats {
+  unsigned int capacity;
+  unsigned int used;
+  unsigned int allocations;
+  unsigned int free_blocks;
+  unsigned int largest_free_block;
+  // 1 - largest free block / total free space: 0 when all free space is one
+  // block, approaching 1 as it splinters into small holes
+  float fragmentation;
+} range_allocator_stats_t;
+
+// Hands out [offset, offset + size) ranges of an abstract capacity (bytes,
+// vertices, indices...). Free ranges are kept sorted by offset so a freed
+// range coalesces with its neighbours; allocation picks the best fit.
+typedef struct range_allocator {
+  range_block_t* free_blocks;  // Sorted by offset, never adjacent
+  unsigned int free_count;
+  unsigned int free_capacity;
+  unsigned int capacity;
+  unsigned int used;
+  unsigned int allocations;
+} range_allocator_t;
+
+range_allocator_t range_allocator_create(unsigned int capacity);
+void range_allocator_destroy(range_allocator_t* allocator);
+
+// Returns the offset of a size long range, or RANGE_ALLOCATOR_INVALID
+unsigned int range_allocator_alloc(range_allocator_t* allocator,
+                                   unsigned int size);
+
+// Return a range previously handed out by range_allocator_alloc
+void range_allocator_free(range_allocator_t* allocator, unsigned int offset,
+                          unsigned int size);
+
+// Extend the managed capacity; the new space is free
+void range_allocator_grow(range_allocator_t* allocator,
+                          unsigned int new_capacity);
+
+range_allocator_stats_t range_allocator_get_stats(
+    const range_allocator_t* allocator);
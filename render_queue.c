@@ -0,0 +1,203 @@
+#include "render_queue.h"
+#include <stdlib.h>
+#include <string.h>
+#include "renderer.h"
+#include "timer.h"
+
+#define INITIAL_CAPACITY 256
+#define DEPTH_BITS 19
+
+static void ensure_capacity(render_queue_t* queue) {
+  if (queue->command_count < queue->commands_capacity) return;
+
+  queue->commands_capacity *= 2;
+  queue->commands = (render_command_t*)realloc(
+      queue->commands, queue->commands_capacity * sizeof(render_command_t));
+  queue->keys = (uint64_t*)realloc(
+      queue->keys, queue->commands_capacity * sizeof(uint64_t));
+  queue->order = (unsigned int*)realloc(
+      queue->order, queue->commands_capacity * sizeof(unsigned int));
+  queue->scratch_keys = (uint64_t*)realloc(
+      queue->scratch_keys, queue->commands_capacity * sizeof(uint64_t));
+  queue->scratch_order = (unsigned int*)realloc(
+      queue->scratch_order, queue->commands_capacity * sizeof(unsigned int));
+}
+
+render_queue_t render_queue_create(void) {
+  render_queue_t queue;
+
+  queue.commands = (render_command_t*)malloc(INITIAL_CAPACITY *
+                                             sizeof(render_command_t));
+  queue.keys = (uint64_t*)malloc(INITIAL_CAPACITY * sizeof(uint64_t));
+  queue.order = (unsigned int*)malloc(INITIAL_CAPACITY * sizeof(unsigned int));
+  queue.scratch_keys = (uint64_t*)malloc(INITIAL_CAPACITY * sizeof(uint64_t));
+  queue.scratch_order =
+      (unsigned int*)malloc(INITIAL_CAPACITY * sizeof(unsigned int));
+  queue.command_count = 0;
+  queue.commands_capacity = INITIAL_CAPACITY;
+  queue.sort = true;
+  memset(&queue.stats, 0, sizeof(queue.stats));
+
+  return queue;
+}
+
+void render_queue_destroy(render_queue_t* queue) {
+  if (queue && queue->commands) {
+    free(queue->commands);
+    free(queue->keys);
+    free(queue->order);
+    free(queue->scratch_keys);
+    free(queue->scratch_order);
+    queue->commands = NULL;
+    queue->command_count = 0;
+    queue->commands_capacity = 0;
+  }
+}
+
+uint64_t render_queue_make_key(unsigned int layer, bool translucent,
+                               unsigned int shader, unsigned int material,
+                               unsigned int mesh, float depth) {
+  if (layer > RENDER_QUEUE_MAX_LAYER) layer = RENDER_QUEUE_MAX_LAYER;
+  if (shader > RENDER_QUEUE_MAX_SHADER) shader = RENDER_QUEUE_MAX_SHADER;
+  if (material > RENDER_QUEUE_MAX_MATERIAL)
+    material = RENDER_QUEUE_MAX_MATERIAL;
+  if (mesh > RENDER_QUEUE_MAX_MESH) mesh = RENDER_QUEUE_MAX_MESH;
+  if (!(depth > 0.0f)) depth = 0.0f;  // Also catches NaN
+  if (depth > 1.0f) depth = 1.0f;
+
+  uint64_t max_depth = (1ull << DEPTH_BITS) - 1;
+  uint64_t quantized = (uint64_t)(depth * (float)max_depth);
+  uint64_t key = (uint64_t)layer << 60;
+
+  if (!translucent) {
+    key |= (uint64_t)shader << 47;
+    key |= (uint64_t)material << 31;
+    key |= (uint64_t)mesh << 19;
+    key |= quantized;
+  } else {
+    key |= 1ull << 59;
+    key |= (max_depth - quantized) << 40;
+    key |= (uint64_t)shader << 28;
+    key |= (uint64_t)material << 12;
+    key |= (uint64_t)mesh;
+  }
+  return key;
+}
+
+void render_queue_submit(render_queue_t* queue,
+                         const render_command_t* command) {
+  ensure_capacity(queue);
+  queue->commands[queue->command_count++] = *command;
+}
+
+// LSD radix sort of (key, index) pairs, a byte per pass. Passes where every
+// key has the same byte are skipped, which with the packed key layout is
+// usually most of them.
+static void radix_sort(render_queue_t* queue) {
+  unsigned int count = queue->command_count;
+  uint64_t* keys = queue->keys;
+  unsigned int* order = queue->order;
+  uint64_t* next_keys = queue->scratch_keys;
+  unsigned int* next_order = queue->scratch_order;
+
+  for (unsigned int i = 0; i < count; i++) {
+    keys[i] = queue->commands[i].key;
+    order[i] = i;
+  }
+
+  for (unsigned int shift = 0; shift < 64; shift += 8) {
+    unsigned int histogram[256] = {0};
+    for (unsigned int i = 0; i < count; i++)
+      histogram[(keys[i] >> shift) & 0xFF]++;
+    if (histogram[(keys[0] >> shift) & 0xFF] == count) continue;
+
+    unsigned int offsets[256];
+    unsigned int sum = 0;
+    for (int bucket = 0; bucket < 256; bucket++) {
+      offsets[bucket] = sum;
+      sum += histogram[bucket];
+    }
+
+    for (unsigned int i = 0; i < count; i++) {
+      unsigned int slot = offsets[(keys[i] >> shift) & 0xFF]++;
+      next_keys[slot] = keys[i];
+      next_order[slot] = order[i];
+    }
+
+    uint64_t* swap_keys = keys;
+    keys = next_keys;
+    next_keys = swap_keys;
+    unsigned int* swap_order = order;
+    order = next_order;
+    next_order = swap_order;
+  }
+
+  // Leave the result where execute reads it
+  if (order != queue->order) {
+    memcpy(queue->order, order, count * sizeof(unsigned int));
+  }
+}
+
+static unsigned int index_type_size(unsigned int type) {
+  switch (type) {
+    case GL_UNSIGNED_BYTE:
+      return 1;
+    case GL_UNSIGNED_SHORT:
+      return 2;
+    default:
+      return 4;
+  }
+}
+
+void render_queue_execute(render_queue_t* queue) {
+  unsigned int count = queue->command_count;
+  memset(&queue->stats, 0, sizeof(queue->stats));
+  queue->stats.commands = count;
+  if (count == 0) return;
+
+  double sort_start = timer_now();
+  if (queue->sort) {
+    radix_sort(queue);
+  } else {
+    for (unsigned int i = 0; i < count; i++) queue->order[i] = i;
+  }
+  queue->stats.sort_ms = timer_elapsed_ms(sort_start);
+
+  // Track what the previous command left bound, for the change counters;
+  // the renderer cache does the actual eliding. Textures are not in it.
+  const render_command_t* previous = NULL;
+  unsigned int bound_texture = 0;
+  for (unsigned int i = 0; i < count; i++) {
+    const render_command_t* command = &queue->commands[queue->order[i]];
+
+    if (!previous || previous->shader != command->shader)
+      queue->stats.shader_changes++;
+    if (!previous || previous->vertex_array != command->vertex_array)
+      queue->stats.vertex_array_changes++;
+    if (command->texture && command->texture != bound_texture) {
+      GLCall(glActiveTexture(GL_TEXTURE0));
+      GLCall(glBindTexture(GL_TEXTURE_2D, command->texture));
+      bound_texture = command->texture;
+      queue->stats.texture_changes++;
+    }
+
+    renderer_use_program(command->shader);
+    renderer_bind_vertex_array(command->vertex_array);
+    renderer_bind_buffer(GL_ELEMENT_ARRAY_BUFFER, command->index_buffer);
+
+    unsigned int index_size = index_type_size(command->index_type);
+    GLCall(glDrawElementsBaseVertex(
+        GL_TRIANGLES, command->index_count, command->index_type,
+        (const void*)(size_t)(command->first_index * index_size),
+        command->base_vertex));
+    queue->stats.draws++;
+
+    previous = command;
+  }
+
+  queue->command_count = 0;
+}
+
+render_queue_stats_t render_queue_get_stats(const render_queue_t* queue) {
+  return queue->stats;
+}
@@ -0,0 +1,75 @@
+#pragma once
+#include <stdbool.h>
+#include <stdint.h>
+
+// Sort key layout, most significant first. Opaque draws sort by state to
+// minimise changes (shader, then material, then mesh, so draws of a mesh
+// keep its vertex array bound), then front to back for early depth
+// rejection; translucent draws must be back to front, so depth moves ahead
+// of state:
+//   opaque:      layer:4 | 0:1 | shader:12 | material:16 | mesh:12 |
+//                depth:19
+//   translucent: layer:4 | 1:1 | far-to-near depth:19 | shader:12 |
+//                material:16 | mesh:12
+#define RENDER_QUEUE_MAX_LAYER 15
+#define RENDER_QUEUE_MAX_SHADER 0xFFF
+#define RENDER_QUEUE_MAX_MATERIAL 0xFFFF
+#define RENDER_QUEUE_MAX_MESH 0xFFF
+
+// One draw: everything needed to issue it, independent of what ran before
+typedef struct render_command {
+  uint64_t key;
+  unsigned int shader;        // GL program
+  unsigned int vertex_array;  // GL vertex array
+  unsigned int index_buffer;  // GL element buffer
+  unsigned int index_type;    // GL_UNSIGNED_SHORT etc.
+  unsigned int index_count;
+  unsigned int first_index;
+  int base_vertex;
+  unsigned int texture;  // Bound to unit 0 if not 0
+} render_command_t;
+
+// Counters for the last render_queue_execute
+typedef struct render_queue_stats {
+  unsigned int commands;
+  unsigned int draws;
+  unsigned int shader_changes;
+  unsigned int vertex_array_changes;
+  unsigned int texture_changes;
+  double sort_ms;
+} render_queue_stats_t;
+
+// Collects draw commands during a frame, radix sorts them by key and
+// issues them with state changes only where consecutive commands differ.
+typedef struct render_queue {
+  render_command_t* commands;
+  unsigned int command_count;
+  unsigned int commands_capacity;
+  // Sort scratch, grown with the commands
+  uint64_t* keys;
+  unsigned int* order;
+  uint64_t* scratch_keys;
+  unsigned int* scratch_order;
+  bool sort;  // Turn off to measure the unsorted submission order
+  render_queue_stats_t stats;
+} render_queue_t;
+
+render_queue_t render_queue_create(void);
+void render_queue_destroy(render_queue_t* queue);
+
+// Build a key. shader, material and mesh are small caller-assigned ids
+// (e.g. an index into the frame's shaders; meshes sharing a vertex array
+// should share an id), clamped to their fields; depth is the normalised
+// view depth in [0, 1], 0 nearest.
+uint64_t render_queue_make_key(unsigned int layer, bool translucent,
+                               unsigned int shader, unsigned int material,
+                               unsigned int mesh, float depth);
+
+void render_queue_submit(render_queue_t* queue,
+                         const render_command_t* command);
+
+// Sort, issue every command through the renderer bind cache and empty the
+// queue
+void render_queue_execute(render_queue_t* queue);
+
+render_queue_stats_t render_queue_get_stats(const render_queue_t* queue);
@@ -1,15 +1,324 @@
 #include "renderer.h"
 #include <stdbool.h>
+#include <stddef.h>
 #include <stdio.h>
+#include "gl_ext.h"
 
-void GLClearError() { while (glGetError() != GL_NO_ERROR); }
+static bool debug_callback_installed = false;
+
+void GLClearError() {
+  if (debug_callback_installed) return;
+  while (glGetError() != GL_NO_ERROR);
+}
 
 bool GLLogCall(const char* function, const char* file, int line) {
+  if (debug_callback_installed) return true;
   GLenum error;
-  while (error = glGetError()) {
+  while ((error = glGetError()) != GL_NO_ERROR) {
     printf("[OpenGL Error] (%u) %s %s %d\n", error, function, file, line);
     return false;
   }
 
   return true;
 }
+
+#if RENDERER_GL_DEBUG
+static bool debug_break_on_error = false;
+
+static const char* debug_source_name(GLenum source) {
+  switch (source) {
+    case GL_DEBUG_SOURCE_API:
+      return "API";
+    case GL_DEBUG_SOURCE_WINDOW_SYSTEM:
+      return "Window System";
+    case GL_DEBUG_SOURCE_SHADER_COMPILER:
+      return "Shader Compiler";
+    case GL_DEBUG_SOURCE_THIRD_PARTY:
+      return "Third Party";
+    case GL_DEBUG_SOURCE_APPLICATION:
+      return "Application";
+    default:
+      return "Other";
+  }
+}
+
+static const char* debug_type_name(GLenum type) {
+  switch (type) {
+    case GL_DEBUG_TYPE_ERROR:
+      return "Error";
+    case GL_DEBUG_TYPE_DEPRECATED_BEHAVIOR:
+      return "Deprecated";
+    case GL_DEBUG_TYPE_UNDEFINED_BEHAVIOR:
+      return "Undefined Behavior";
+    case GL_DEBUG_TYPE_PORTABILITY:
+      return "Portability";
+    case GL_DEBUG_TYPE_PERFORMANCE:
+      return "Performance";
+    case GL_DEBUG_TYPE_MARKER:
+      return "Marker";
+    default:
+      return "Other";
+  }
+}
+
+static const char* debug_severity_name(GLenum severity) {
+  switch (severity) {
+    case GL_DEBUG_SEVERITY_HIGH:
+      return "high";
+    case GL_DEBUG_SEVERITY_MEDIUM:
+      return "medium";
+    case GL_DEBUG_SEVERITY_LOW:
+      return "low";
+    default:
+      return "notification";
+  }
+}
+
+static void APIENTRY debug_callback(GLenum source, GLenum type, GLuint id,
+                                    GLenum severity, GLsizei length,
+                                    const GLchar* message,
+                                    const void* user_param) {
+  (void)user_param;
+  printf("[OpenGL %s] (%u) %s, %s: %.*s\n", debug_type_name(type), id,
+         debug_source_name(source), debug_severity_name(severity),
+         (int)length, message);
+
+  if (type == GL_DEBUG_TYPE_ERROR && debug_break_on_error) {
+    ASSERT(false);
+  }
+}
+#endif
+
+renderer_debug_options_t renderer_debug_default_options(void) {
+  renderer_debug_options_t options;
+  options.synchronous = true;
+  options.min_severity = GL_DEBUG_SEVERITY_LOW;
+  options.source = GL_DONT_CARE;
+  options.type = GL_DONT_CARE;
+  options.break_on_error = true;
+  return options;
+}
+
+bool renderer_debug_install(const renderer_debug_options_t* options) {
+#if RENDERER_GL_DEBUG == 0
+  return false;
+#else
+  if (!gl_ext.debug_output) return false;
+
+  static const GLenum SEVERITIES[] = {
+      GL_DEBUG_SEVERITY_HIGH, GL_DEBUG_SEVERITY_MEDIUM, GL_DEBUG_SEVERITY_LOW,
+      GL_DEBUG_SEVERITY_NOTIFICATION};
+
+  // ARB_debug_output contexts have no GL_DEBUG_OUTPUT switch, so the enable
+  // may raise an error there; clear it either way.
+  glEnable(GL_DEBUG_OUTPUT);
+  if (options->synchronous) {
+    glEnable(GL_DEBUG_OUTPUT_SYNCHRONOUS);
+  } else {
+    glDisable(GL_DEBUG_OUTPUT_SYNCHRONOUS);
+  }
+  while (glGetError() != GL_NO_ERROR);
+
+  // Mute everything, then re-enable the filtered set severity by severity
+  glDebugMessageControl(GL_DONT_CARE, GL_DONT_CARE, GL_DONT_CARE, 0, NULL,
+                        GL_FALSE);
+  for (unsigned int i = 0; i < sizeof(SEVERITIES) / sizeof(SEVERITIES[0]);
+       i++) {
+    glDebugMessageControl(options->source, options->type, SEVERITIES[i], 0,
+                          NULL, GL_TRUE);
+    if (SEVERITIES[i] == options->min_severity) break;
+  }
+
+  debug_break_on_error = options->break_on_error;
+  glDebugMessageCallback(debug_callback, NULL);
+  // Mode 2 keeps polling on top of the callback
+  debug_callback_installed = RENDERER_GL_DEBUG == 1;
+  return true;
+#endif
+}
+
+#define UNKNOWN_BINDING 0xFFFFFFFFu
+
+typedef struct vertex_binding {
+  unsigned int buffer;
+  size_t offset;
+  unsigned int stride;
+} vertex_binding_t;
+
+typedef struct buffer_range_binding {
+  unsigned int buffer;
+  size_t offset;
+  size_t size;
+} buffer_range_binding_t;
+
+typedef struct renderer_state {
+  unsigned int program;
+  unsigned int vertex_array;
+  unsigned int array_buffer;
+  // Part of the bound vertex array's state
+  unsigned int element_buffer;
+  vertex_binding_t vertex_buffers[RENDERER_MAX_VERTEX_BINDINGS];
+  // Context state, kept across vertex array changes
+  buffer_range_binding_t uniform_buffers[RENDERER_MAX_UNIFORM_BINDINGS];
+} renderer_state_t;
+
+// Zero until renderer_invalidate_state marks every binding unknown, which
+// context_create does once the context is current
+static renderer_state_t state;
+static renderer_stats_t stats;
+
+static bool needs_bind(unsigned int* cached, unsigned int id) {
+  if (*cached == id) {
+    stats.binds_elided++;
+    return false;
+  }
+  *cached = id;
+  stats.binds_issued++;
+  return true;
+}
+
+void renderer_use_program(unsigned int program) {
+  if (needs_bind(&state.program, program)) {
+    GLCall(glUseProgram(program));
+  }
+}
+
+static void forget_vertex_array_bindings(void) {
+  state.element_buffer = UNKNOWN_BINDING;
+  for (unsigned int i = 0; i < RENDERER_MAX_VERTEX_BINDINGS; i++)
+    state.vertex_buffers[i].buffer = UNKNOWN_BINDING;
+}
+
+void renderer_bind_vertex_array(unsigned int vertex_array) {
+  if (needs_bind(&state.vertex_array, vertex_array)) {
+    GLCall(glBindVertexArray(vertex_array));
+    // Each vertex array has its own element and vertex buffer bindings
+    forget_vertex_array_bindings();
+  }
+}
+
+void renderer_bind_vertex_buffer(unsigned int binding, unsigned int buffer,
+                                 size_t offset, unsigned int stride) {
+  if (binding < RENDERER_MAX_VERTEX_BINDINGS) {
+    vertex_binding_t* cached = &state.vertex_buffers[binding];
+    if (cached->buffer == buffer && cached->offset == offset &&
+        cached->stride == stride) {
+      stats.binds_elided++;
+      return;
+    }
+    cached->buffer = buffer;
+    cached->offset = offset;
+    cached->stride = stride;
+  }
+
+  stats.binds_issued++;
+  GLCall(glBindVertexBuffer(binding, buffer, (GLintptr)offset, stride));
+}
+
+void renderer_bind_buffer(unsigned int target, unsigned int buffer) {
+  unsigned int* cached = NULL;
+  if (target == GL_ARRAY_BUFFER) {
+    cached = &state.array_buffer;
+  } else if (target == GL_ELEMENT_ARRAY_BUFFER) {
+    cached = &state.element_buffer;
+  }
+
+  if (!cached || needs_bind(cached, buffer)) {
+    GLCall(glBindBuffer(target, buffer));
+  }
+}
+
+void renderer_bind_buffer_range(unsigned int target, unsigned int index,
+                                unsigned int buffer, size_t offset,
+                                size_t size) {
+  if (target == GL_UNIFORM_BUFFER && index < RENDERER_MAX_UNIFORM_BINDINGS) {
+    buffer_range_binding_t* cached = &state.uniform_buffers[index];
+    if (cached->buffer == buffer && cached->offset == offset &&
+        cached->size == size) {
+      stats.binds_elided++;
+      return;
+    }
+    cached->buffer = buffer;
+    cached->offset = offset;
+    cached->size = size;
+  }
+
+  stats.binds_issued++;
+  GLCall(glBindBufferRange(target, index, buffer, (GLintptr)offset,
+                           (GLsizeiptr)size));
+}
+
+static void forget_uniform_bindings(void) {
+  for (unsigned int i = 0; i < RENDERER_MAX_UNIFORM_BINDINGS; i++)
+    state.uniform_buffers[i].buffer = UNKNOWN_BINDING;
+}
+
+void renderer_forget_program(unsigned int program) {
+  if (state.program == program) state.program = UNKNOWN_BINDING;
+}
+
+void renderer_forget_vertex_array(unsigned int vertex_array) {
+  if (state.vertex_array == vertex_array) {
+    state.vertex_array = UNKNOWN_BINDING;
+    forget_vertex_array_bindings();
+  }
+}
+
+void renderer_forget_buffer(unsigned int buffer) {
+  if (state.array_buffer == buffer) state.array_buffer = UNKNOWN_BINDING;
+  if (state.element_buffer == buffer) state.element_buffer = UNKNOWN_BINDING;
+  for (unsigned int i = 0; i < RENDERER_MAX_VERTEX_BINDINGS; i++) {
+    if (state.vertex_buffers[i].buffer == buffer)
+      state.vertex_buffers[i].buffer = UNKNOWN_BINDING;
+  }
+  for (unsigned int i = 0; i < RENDERER_MAX_UNIFORM_BINDINGS; i++) {
+    if (state.uniform_buffers[i].buffer == buffer)
+      state.uniform_buffers[i].buffer = UNKNOWN_BINDING;
+  }
+}
+
+void renderer_invalidate_state(void) {
+  state.program = UNKNOWN_BINDING;
+  state.vertex_array = UNKNOWN_BINDING;
+  state.array_buffer = UNKNOWN_BINDING;
+  forget_vertex_array_bindings();
+  forget_uniform_bindings();
+}
+
+void renderer_record_uniform_upload(bool issued) {
+  if (issued) {
+    stats.uniform_uploads++;
+  } else {
+    stats.uniform_uploads_elided++;
+  }
+}
+
+void renderer_begin_frame(void) {
+  stats.binds_issued = 0;
+  stats.binds_elided = 0;
+  stats.uniform_uploads = 0;
+  stats.uniform_uploads_elided = 0;
+}
+
+renderer_stats_t renderer_get_stats(void) { return stats; }
+
+void renderer_draw(vertex_array_t* array, index_buffer_t* indices,
+                   unsigned int shader) {
+  renderer_use_program(shader);
+  vertex_array_bind(array);
+  index_buffer_bind(indices);
+
+  GLCall(glDrawElements(GL_TRIANGLES, index_buffer_get_count(indices),
+                        index_buffer_get_type(indices), NULL));
+}
+
+void renderer_draw_instanced(vertex_array_t* array, index_buffer_t* indices,
+                             unsigned int shader, unsigned int instance_count) {
+  renderer_use_program(shader);
+  vertex_array_bind(array);
+  index_buffer_bind(indices);
+
+  GLCall(glDrawElementsInstanced(GL_TRIANGLES, index_buffer_get_count(indices),
+                                 index_buffer_get_type(indices), NULL,
+                                 instance_count));
+}
@@ -1,15 +1,119 @@
 #pragma once
 #include <glad/glad.h>
 #include <stdbool.h>
+#include <stddef.h>
+#include "index_buffer.h"
+#include "vertex_array.h"
+
+#if defined(_MSC_VER)
+#define DEBUG_BREAK() __debugbreak()
+#elif defined(__GNUC__) || defined(__clang__)
+#define DEBUG_BREAK() __builtin_trap()
+#else
+#include <stdlib.h>
+#define DEBUG_BREAK() abort()
+#endif
 
 #define ASSERT(x) \
-  if (!(x)) __debugbreak();
+  if (!(x)) DEBUG_BREAK();
+
+// How GL errors are caught, chosen at build time:
+//   0 - GLCall is the bare call, no error checking at all (release)
+//   1 - errors are reported by the KHR_debug callback installed with
+//       renderer_debug_install; GLCall only polls glGetError when no
+//       callback could be installed
+//   2 - always poll glGetError around every GLCall
+// Defaults to 0 when NDEBUG is defined and 1 otherwise.
+#ifndef RENDERER_GL_DEBUG
+#ifdef NDEBUG
+#define RENDERER_GL_DEBUG 0
+#else
+#define RENDERER_GL_DEBUG 1
+#endif
+#endif
 
+#if RENDERER_GL_DEBUG
 #define GLCall(x) \
   GLClearError(); \
   x;              \
   ASSERT(GLLogCall(#x, __FILE__, __LINE__))
+#else
+#define GLCall(x) x
+#endif
 
+// Both are no-ops once a debug callback is installed (mode 1), so GLCall no
+// longer costs a glGetError round trip per call
 void GLClearError();
-
 bool GLLogCall(const char* function, const char* file, int line);
+
+typedef struct renderer_debug_options {
+  bool synchronous;           // Report on the offending call's stack
+  unsigned int min_severity;  // Lowest GL_DEBUG_SEVERITY_* reported
+  unsigned int source;        // A GL_DEBUG_SOURCE_* or GL_DONT_CARE for all
+  unsigned int type;          // A GL_DEBUG_TYPE_* or GL_DONT_CARE for all
+  bool break_on_error;        // ASSERT on GL_DEBUG_TYPE_ERROR messages
+} renderer_debug_options_t;
+
+// Synchronous, low severity and up, every source and type, break on errors
+renderer_debug_options_t renderer_debug_default_options(void);
+
+// Install the debug message callback with the given filter. Returns false
+// if the context has no debug output (GLCall then keeps polling) or the
+// build has GL error checking compiled out.
+bool renderer_debug_install(const renderer_debug_options_t* options);
+
+// Bind counters since the last renderer_begin_frame
+typedef struct renderer_stats {
+  unsigned int binds_issued;
+  unsigned int binds_elided;  // Skipped because the object was already bound
+  unsigned int uniform_uploads;
+  unsigned int uniform_uploads_elided;  // Value was already set
+} renderer_stats_t;
+
+// Cached binds. Each one only reaches GL when the binding actually changes.
+// Code that binds behind the cache's back must call
+// renderer_invalidate_state afterwards.
+void renderer_use_program(unsigned int program);
+void renderer_bind_vertex_array(unsigned int vertex_array);
+// GL_ARRAY_BUFFER and GL_ELEMENT_ARRAY_BUFFER are cached, other targets are
+// passed straight through
+void renderer_bind_buffer(unsigned int target, unsigned int buffer);
+// glBindVertexBuffer (vertex_attrib_binding); the first
+// RENDERER_MAX_VERTEX_BINDINGS binding points of the bound vertex array are
+// cached
+#define RENDERER_MAX_VERTEX_BINDINGS VERTEX_ARRAY_MAX_BINDINGS
+void renderer_bind_vertex_buffer(unsigned int binding, unsigned int buffer,
+                                 size_t offset, unsigned int stride);
+// glBindBufferRange; the first RENDERER_MAX_UNIFORM_BINDINGS
+// GL_UNIFORM_BUFFER binding points are cached, other targets pass through
+#define RENDERER_MAX_UNIFORM_BINDINGS 8
+void renderer_bind_buffer_range(unsigned int target, unsigned int index,
+                                unsigned int buffer, size_t offset,
+                                size_t size);
+
+// GL reuses names of deleted objects, so drop them from the cache on delete
+void renderer_forget_program(unsigned int program);
+void renderer_forget_vertex_array(unsigned int vertex_array);
+void renderer_forget_buffer(unsigned int buffer);
+
+// Assume nothing about the current bindings. Call once a context is made
+// current (context_create does).
+void renderer_invalidate_state(void);
+
+// Bind shader, vertex array and index buffer (through the cache) and draw
+// all of the index buffer's triangles with its index type
+void renderer_draw(vertex_array_t* array, index_buffer_t* indices,
+                   unsigned int shader);
+
+// renderer_draw for instance_count instances in one call; per-instance
+// attributes come from buffers added with a layout divisor
+void renderer_draw_instanced(vertex_array_t* array, index_buffer_t* indices,
+                             unsigned int shader, unsigned int instance_count);
+
+// Count a uniform upload (shader setters call this); elided ones were
+// skipped because the uniform already held the value
+void renderer_record_uniform_upload(bool issued);
+
+// Reset the per-frame counters
+void renderer_begin_frame(void);
+renderer_stats_t renderer_get_stats(void);
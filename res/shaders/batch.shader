@@ -0,0 +1,51 @@
+#shader vertex
+#version 330 core
+
+layout(location = 0) in vec2 a_Position;
+layout(location = 1) in vec2 a_TexCoord;
+layout(location = 2) in vec4 a_Color;
+layout(location = 3) in float a_TexIndex;
+
+uniform mat4 u_ViewProjection;
+
+out vec2 v_TexCoord;
+out vec4 v_Color;
+flat out int v_TexIndex;
+
+void main()
+{
+    v_TexCoord = a_TexCoord;
+    v_Color = a_Color;
+    v_TexIndex = int(a_TexIndex);
+    gl_Position = u_ViewProjection * vec4(a_Position, 0.0, 1.0);
+}
+
+#shader fragment
+#version 330 core
+
+layout(location = 0) out vec4 color;
+
+in vec2 v_TexCoord;
+in vec4 v_Color;
+flat in int v_TexIndex;
+
+// GLSL 3.30 only allows constant sampler array indices, hence the switch.
+// Keep the size in sync with BATCH_RENDERER_MAX_TEXTURES.
+uniform sampler2D u_Textures[8];
+
+void main()
+{
+    vec4 texel;
+    switch (v_TexIndex)
+    {
+        case 0: texel = texture(u_Textures[0], v_TexCoord); break;
+        case 1: texel = texture(u_Textures[1], v_TexCoord); break;
+        case 2: texel = texture(u_Textures[2], v_TexCoord); break;
+        case 3: texel = texture(u_Textures[3], v_TexCoord); break;
+        case 4: texel = texture(u_Textures[4], v_TexCoord); break;
+        case 5: texel = texture(u_Textures[5], v_TexCoord); break;
+        case 6: texel = texture(u_Textures[6], v_TexCoord); break;
+        default: texel = texture(u_Textures[7], v_TexCoord); break;
+    }
+    color = texel * v_Color;
+}
@@ -0,0 +1,27 @@
+#shader vertex
+#version 330 core
+
+layout(location = 0) in vec2 a_Position;
+// Per instance
+layout(location = 1) in mat4 a_Transform;
+layout(location = 5) in vec4 a_Color;
+
+out vec4 v_Color;
+
+void main()
+{
+    v_Color = a_Color;
+    gl_Position = a_Transform * vec4(a_Position, 0.0, 1.0);
+}
+
+#shader fragment
+#version 330 core
+
+layout(location = 0) out vec4 color;
+
+in vec4 v_Color;
+
+void main()
+{
+    color = v_Color;
+}
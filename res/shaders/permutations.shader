@@ -0,0 +1,54 @@
+#shader vertex
+#version 330 core
+
+layout(location = 0) in vec2 a_Position;
+layout(location = 1) in vec2 a_TexCoord;
+layout(location = 2) in vec4 a_Color;
+
+out vec2 v_TexCoord;
+out vec4 v_Color;
+
+#ifdef USE_WAVE
+uniform float u_Time;
+#endif
+
+void main()
+{
+    vec2 position = a_Position;
+#ifdef USE_WAVE
+    position.y += 0.05 * sin(position.x * 8.0 + u_Time);
+#endif
+    v_TexCoord = a_TexCoord;
+#ifdef USE_VERTEX_COLOR
+    v_Color = a_Color;
+#else
+    v_Color = vec4(1.0);
+#endif
+    gl_Position = vec4(position, 0.0, 1.0);
+}
+
+#shader fragment
+#version 330 core
+
+layout(location = 0) out vec4 color;
+
+in vec2 v_TexCoord;
+in vec4 v_Color;
+
+#ifdef USE_TEXTURE
+uniform sampler2D u_Texture;
+#endif
+#ifdef USE_FOG
+uniform vec4 u_FogColor;
+#endif
+
+void main()
+{
+    color = v_Color;
+#ifdef USE_TEXTURE
+    color *= texture(u_Texture, v_TexCoord);
+#endif
+#ifdef USE_FOG
+    color = mix(color, u_FogColor, gl_FragCoord.z * 0.5);
+#endif
+}
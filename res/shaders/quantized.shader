@@ -0,0 +1,41 @@
+#shader vertex
+#version 330 core
+
+layout(location = 0) in vec3 a_Position;
+#ifdef OCTAHEDRAL_NORMALS
+layout(location = 1) in vec2 a_Normal;
+#else
+layout(location = 1) in vec3 a_Normal;
+#endif
+
+uniform mat4 u_Model;
+
+out vec3 v_Normal;
+
+void main()
+{
+#ifdef OCTAHEDRAL_NORMALS
+    vec3 normal = vec3(a_Normal, 1.0 - abs(a_Normal.x) - abs(a_Normal.y));
+    if (normal.z < 0.0)
+        normal.xy = (1.0 - abs(normal.yx)) * sign(normal.xy);
+    normal = normalize(normal);
+#else
+    vec3 normal = a_Normal;
+#endif
+    v_Normal = mat3(u_Model) * normal;
+    gl_Position = u_Model * vec4(a_Position, 1.0);
+}
+
+#shader fragment
+#version 330 core
+
+layout(location = 0) out vec4 color;
+
+in vec3 v_Normal;
+
+void main()
+{
+    vec3 normal = normalize(v_Normal);
+    float diffuse = max(dot(normal, normalize(vec3(0.4, 0.6, -0.7))), 0.0);
+    color = vec4(vec3(0.15 + 0.85 * diffuse) * (normal * 0.5 + 0.5), 1.0);
+}
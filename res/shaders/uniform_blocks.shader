@@ -0,0 +1,45 @@
+#shader vertex
+#version 330 core
+
+layout(location = 0) in vec2 a_Position;
+
+layout(std140) uniform Frame
+{
+    float u_Time;
+};
+
+layout(std140) uniform View
+{
+    mat4 u_ViewProjection;
+};
+
+layout(std140) uniform Material
+{
+    vec4 u_Color;
+    vec2 u_Offset;
+    float u_Scale;
+};
+
+void main()
+{
+    float c = cos(u_Time), s = sin(u_Time);
+    vec2 position = mat2(c, s, -s, c) * a_Position * u_Scale + u_Offset;
+    gl_Position = u_ViewProjection * vec4(position, 0.0, 1.0);
+}
+
+#shader fragment
+#version 330 core
+
+layout(location = 0) out vec4 color;
+
+layout(std140) uniform Material
+{
+    vec4 u_Color;
+    vec2 u_Offset;
+    float u_Scale;
+};
+
+void main()
+{
+    color = u_Color;
+}
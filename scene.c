@@ -0,0 +1,66 @@
+#include "scene.h"
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+static const scene_t* const SCENES[] = {
+    &scene_basic,     &scene_batch,    &scene_queue,  &scene_indirect,
+    &scene_instances, &scene_uniforms, &scene_stream, &scene_quantized,
+};
+
+#define SCENE_COUNT (sizeof(SCENES) / sizeof(SCENES[0]))
+
+const scene_t* scene_find(const char* name) {
+  for (unsigned int i = 0; i < SCENE_COUNT; i++) {
+    if (strcmp(name, SCENES[i]->name) == 0) return SCENES[i];
+  }
+
+  printf("Unknown scene '%s'. Scenes:\n", name);
+  for (unsigned int i = 0; i < SCENE_COUNT; i++)
+    printf("  %-10s %s\n", SCENES[i]->name, SCENES[i]->description);
+  return NULL;
+}
+
+bool scene_add_shapes(mesh_arena_t* arena, mesh_arena_mesh_t* shapes) {
+  float triangle[] = {-0.87f, -0.5f, 0.87f, -0.5f, 0.0f, 1.0f};
+  unsigned int triangle_indices[] = {0, 1, 2};
+  float quad[] = {-0.7f, -0.7f, 0.7f, -0.7f, 0.7f, 0.7f, -0.7f, 0.7f};
+  unsigned int quad_indices[] = {0, 1, 2, 2, 3, 0};
+
+  // Centre and six corners, fanned
+  float hexagon[14] = {0.0f, 0.0f};
+  unsigned int hexagon_indices[18];
+  for (unsigned int i = 0; i < 6; i++) {
+    float angle = (float)i * 3.14159265f / 3.0f;
+    hexagon[2 + i * 2] = cosf(angle);
+    hexagon[3 + i * 2] = sinf(angle);
+    hexagon_indices[i * 3] = 0;
+    hexagon_indices[i * 3 + 1] = 1 + i;
+    hexagon_indices[i * 3 + 2] = 1 + (i + 1) % 6;
+  }
+
+  return mesh_arena_alloc(arena, triangle, 3, triangle_indices, 3,
+                          &shapes[0]) &&
+         mesh_arena_alloc(arena, quad, 4, quad_indices, 6, &shapes[1]) &&
+         mesh_arena_alloc(arena, hexagon, 7, hexagon_indices, 18, &shapes[2]);
+}
+
+vertex_buffer_layout_t scene_instance_layout(void) {
+  vertex_buffer_layout_t layout = vertex_buffer_layout_create();
+  vertex_buffer_layout_push_mat4(&layout);
+  vertex_buffer_layout_push_float(&layout, 4);
+  vertex_buffer_layout_set_divisor(&layout, 1);
+  vertex_buffer_layout_build(&layout);
+  return layout;
+}
+
+void scene_instance_set(scene_instance_t* instance, float x, float y,
+                        float size, float angle, const float* color) {
+  float c = cosf(angle) * size, s = sinf(angle) * size;
+  float transform[16] = {c,    s,    0.0f, 0.0f,  // Column 0
+                         -s,   c,    0.0f, 0.0f,  // Column 1
+                         0.0f, 0.0f, 1.0f, 0.0f,  // Column 2
+                         x,    y,    0.0f, 1.0f};
+  memcpy(instance->transform, transform, sizeof(transform));
+  memcpy(instance->color, color, sizeof(instance->color));
+}
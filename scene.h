@@ -0,0 +1,56 @@
+#pragma once
+#include <stdbool.h>
+#include "mesh_arena.h"
+#include "vertex_buffer_layout.h"
+
+// Scenes drawn by main's render loop, picked with --scene <name>. There is
+// one per draw path, so every path runs unchanged on the headless context
+// and its image can be checked with context_checksum. create sets up
+// resources on the current context and returns the scene's state (NULL on
+// failure); frame draws one frame after the loop has cleared the target;
+// destroy prints the scene's counters and releases everything. Frames may
+// only depend on the frame number, never on time, so every run of a scene
+// renders the same images.
+typedef struct scene {
+  const char* name;
+  const char* description;
+  void* (*create)(void);
+  void (*frame)(void* state, unsigned int frame);
+  void (*destroy)(void* state);
+} scene_t;
+
+// One per scene_*.c
+extern const scene_t scene_basic;
+extern const scene_t scene_batch;
+extern const scene_t scene_queue;
+extern const scene_t scene_indirect;
+extern const scene_t scene_instances;
+extern const scene_t scene_uniforms;
+extern const scene_t scene_stream;
+extern const scene_t scene_quantized;
+
+// The scene called name. Lists the scenes and returns NULL if there is no
+// such scene.
+const scene_t* scene_find(const char* name);
+
+// Helpers shared by the scenes drawing res/shaders/instanced.shader
+
+#define SCENE_SHAPE_COUNT 3
+
+// A triangle, a quad and a hexagon of radius 1 around the origin, as vec2
+// positions, placed into arena. Returns false if one did not fit.
+bool scene_add_shapes(mesh_arena_t* arena, mesh_arena_mesh_t* shapes);
+
+// Per-instance data of instanced.shader
+typedef struct scene_instance {
+  float transform[16];  // Column-major
+  float color[4];
+} scene_instance_t;
+
+// The per-instance layout (divisor 1) matching scene_instance_t, built
+vertex_buffer_layout_t scene_instance_layout(void);
+
+// Scale by size, rotate by angle radians and move to x, y in clip space.
+// color is RGBA.
+void scene_instance_set(scene_instance_t* instance, float x, float y,
+                        float size, float angle, const float* color);
@@ -0,0 +1,136 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include "file_watcher.h"
+#include "index_buffer.h"
+#include "program_cache.h"
+#include "renderer.h"
+#include "scene.h"
+#include "shader.h"
+#include "shader_preprocessor.h"
+#include "shader_reload.h"
+#include "shader_source.h"
+#include "timer.h"
+#include "vertex_array.h"
+#include "vertex_array_cache.h"
+#include "vertex_buffer.h"
+#include "vertex_buffer_layout.h"
+
+typedef struct basic_scene {
+  program_cache_t program_cache;
+  vertex_buffer_t vb;
+  index_buffer_t ib;
+  vertex_buffer_layout_t layout;
+  vertex_array_cache_t vertex_arrays;
+  vertex_array_t va;
+  shader_t shader;
+  file_watcher_t watcher;
+  shader_reload_t shader_reload;
+  float r;
+  float increment;
+} basic_scene_t;
+
+// One quad with a pulsing colour, its shader rebuilt when
+// res/shaders/basic.shader changes
+static void* basic_create(void) {
+  basic_scene_t* scene = (basic_scene_t*)malloc(sizeof(basic_scene_t));
+
+  // Submit shader builds first so the driver compiles them while we set up
+  // the geometry
+  double parse_start = timer_now();
+  // Loaded the way shader_reload rebuilds it, so edits may add #includes
+  shader_source_t source =
+      shader_preprocess_load("res/shaders/basic.shader", NULL, 0, 0, NULL);
+  printf("Parsed %zu byte shader in %.3f ms\n", source.view.size,
+         timer_elapsed_ms(parse_start));
+
+  scene->program_cache = program_cache_create("shader_cache");
+  program_cache_build_t shader_build =
+      program_cache_begin(&scene->program_cache, &source);
+  shader_source_destroy(&source);
+
+  float positions[] = {
+      -0.5f, -0.5f,  // bottom left
+      0.5f,  -0.5f,  // bottom right
+      0.5f,  0.5f,   // top right
+      -0.5f, 0.5f    // top left
+  };
+
+  unsigned int indicies[] = {0, 1, 2, 2, 3, 0};
+
+  scene->vb = vertex_buffer_create(positions, 4 * 2 * sizeof(float));
+
+  scene->layout = vertex_buffer_layout_create();
+  vertex_buffer_layout_push_float(&scene->layout, 2);  // x,y position
+  vertex_buffer_layout_build(&scene->layout);
+
+  scene->ib = index_buffer_create(indicies, 6);
+
+  // Meshes sharing these buffers and format get the same vertex array
+  scene->vertex_arrays = vertex_array_cache_create();
+  scene->va = vertex_array_cache_get(&scene->vertex_arrays, &scene->vb,
+                                     &scene->layout, &scene->ib);
+
+  // Wait for the program only now that it is first used
+  scene->shader = shader_create(
+      program_cache_finish(&scene->program_cache, &shader_build));
+  program_cache_print_stats(&scene->program_cache);
+
+  // Edits to the shader file are rebuilt and swapped in while running
+  scene->watcher = file_watcher_create();
+  scene->shader_reload = shader_reload_create(
+      &scene->shader, &scene->watcher, &scene->program_cache,
+      "res/shaders/basic.shader", NULL, 0, 0);
+
+  ASSERT(shader_find_uniform(&scene->shader, "u_Color"));
+  shader_set_vec4(&scene->shader, "u_Color", 1.0f, 0.5f, 0.3f, 1.0f);
+
+  // unbinding
+  vertex_array_unbind();
+  renderer_use_program(0);
+  vertex_buffer_unbind();
+  index_buffer_unbind();
+
+  scene->r = 0.0f;
+  scene->increment = 0.05f;
+  return scene;
+}
+
+static void basic_frame(void* state, unsigned int frame) {
+  basic_scene_t* scene = (basic_scene_t*)state;
+  (void)frame;  // The colour steps once per call
+
+  file_watcher_poll(&scene->watcher);
+  if (shader_reload_update(&scene->shader_reload, &scene->watcher)) {
+    printf("Reloaded shader in %.2f ms over %u frames\n",
+           scene->shader_reload.stats.last_ms,
+           scene->shader_reload.stats.last_frames);
+  }
+
+  shader_set_vec4(&scene->shader, "u_Color", scene->r, 0.5f, 0.3f, 1.0f);
+
+  renderer_draw(&scene->va, &scene->ib, scene->shader.m_renderer_id);
+
+  if (scene->r > 1.0f)
+    scene->increment = -.05f;
+  else if (scene->r < 0.0f)
+    scene->increment = 0.05f;
+
+  scene->r += scene->increment;
+}
+
+static void basic_destroy(void* state) {
+  basic_scene_t* scene = (basic_scene_t*)state;
+
+  shader_reload_destroy(&scene->shader_reload);
+  file_watcher_destroy(&scene->watcher);
+  shader_destroy(&scene->shader);
+  vertex_array_cache_destroy(&scene->vertex_arrays);
+  vertex_buffer_destroy(&scene->vb);
+  index_buffer_destroy(&scene->ib);
+  vertex_buffer_layout_destroy(&scene->layout);
+  program_cache_destroy(&scene->program_cache);
+  free(scene);
+}
+
+const scene_t scene_basic = {"basic", "the quad with hot shader reload",
+                             basic_create, basic_frame, basic_destroy};
@@ -0,0 +1,99 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include "batch_renderer.h"
+#include "bench.h"
+#include "renderer.h"
+#include "scene.h"
+
+#define QUADS 12000  // More than a batch holds, so it flushes when full
+#define TEXTURES 12  // More than the slots, so it flushes for textures
+
+typedef struct batch_scene {
+  shader_t shader;
+  batch_renderer_t batch;
+  unsigned int textures[TEXTURES];
+} batch_scene_t;
+
+// 2x2 checkerboards, each in its own colour
+static void create_textures(unsigned int* textures) {
+  GLCall(glGenTextures(TEXTURES, textures));
+  for (unsigned int i = 0; i < TEXTURES; i++) {
+    unsigned char color[4] = {(unsigned char)(i * 20), 255,
+                              (unsigned char)(255 - i * 20), 255};
+    unsigned char texels[16];
+    for (int texel = 0; texel < 4; texel++) {
+      bool lit = (texel == 0 || texel == 3);
+      for (int channel = 0; channel < 4; channel++)
+        texels[texel * 4 + channel] = lit ? color[channel] : 64;
+    }
+    GLCall(glBindTexture(GL_TEXTURE_2D, textures[i]));
+    GLCall(glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, 2, 2, 0, GL_RGBA,
+                        GL_UNSIGNED_BYTE, texels));
+    GLCall(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST));
+    GLCall(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST));
+  }
+}
+
+// Quads scattered over the target, half flat coloured and half textured
+// with one of more textures than a batch can bind
+static void* batch_create(void) {
+  unsigned int program = bench_load_program("res/shaders/batch.shader");
+  if (!program) return NULL;
+
+  batch_scene_t* scene = (batch_scene_t*)malloc(sizeof(batch_scene_t));
+  scene->shader = shader_create(program);
+  scene->batch = batch_renderer_create(&scene->shader);
+  create_textures(scene->textures);
+  return scene;
+}
+
+static void batch_frame(void* state, unsigned int frame) {
+  batch_scene_t* scene = (batch_scene_t*)state;
+
+  // Pixels to clip space for the 600x400 target, y up
+  float view_projection[16] = {2.0f / 600.0f, 0.0f, 0.0f, 0.0f,  //
+                               0.0f, 2.0f / 400.0f, 0.0f, 0.0f,  //
+                               0.0f, 0.0f, -1.0f, 0.0f,          //
+                               -1.0f, -1.0f, 0.0f, 1.0f};
+  float uv[4] = {0.0f, 0.0f, 1.0f, 1.0f};
+
+  batch_renderer_begin(&scene->batch, view_projection);
+  unsigned int random = 1;
+  for (unsigned int i = 0; i < QUADS; i++) {
+    // Drift right over the frames, wrapping at the edge
+    float x = bench_random_float(&random) * 600.0f + (float)(frame % 600);
+    if (x >= 600.0f) x -= 600.0f;
+    float position[2] = {x, bench_random_float(&random) * 400.0f};
+    float size[2] = {2.0f + bench_random_float(&random) * 6.0f,
+                     2.0f + bench_random_float(&random) * 6.0f};
+    float color[4] = {bench_random_float(&random),
+                      bench_random_float(&random),
+                      bench_random_float(&random), 1.0f};
+
+    // Textures in runs, as a sprite sheet per layer would be
+    if (bench_random(&random) % 2) {
+      unsigned int texture = i * TEXTURES / QUADS;
+      batch_renderer_draw_textured_quad(&scene->batch, position, size,
+                                        scene->textures[texture], uv, color);
+    } else {
+      batch_renderer_draw_quad(&scene->batch, position, size, color);
+    }
+  }
+  batch_renderer_end(&scene->batch);
+}
+
+static void batch_destroy(void* state) {
+  batch_scene_t* scene = (batch_scene_t*)state;
+
+  batch_renderer_stats_t stats = batch_renderer_get_stats(&scene->batch);
+  printf("Last frame: %u quads in %u draws, %u for textures\n", stats.quads,
+         stats.draws, stats.texture_flushes);
+
+  GLCall(glDeleteTextures(TEXTURES, scene->textures));
+  batch_renderer_destroy(&scene->batch);
+  shader_destroy(&scene->shader);
+  free(scene);
+}
+
+const scene_t scene_batch = {"batch", "batch_renderer quads, some textured",
+                             batch_create, batch_frame, batch_destroy};
@@ -0,0 +1,110 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include "bench.h"
+#include "indirect_draw.h"
+#include "mesh_arena.h"
+#include "renderer.h"
+#include "scene.h"
+#include "vertex_array.h"
+#include "vertex_buffer.h"
+#include "vertex_buffer_layout.h"
+
+#define GRID_SIZE 24  // Instances per row and column
+#define INSTANCES (GRID_SIZE * GRID_SIZE)
+
+typedef struct indirect_scene {
+  unsigned int program;
+  mesh_arena_t arena;
+  vertex_buffer_layout_t vertex_layout;
+  vertex_buffer_layout_t instance_layout;
+  vertex_buffer_t instances;
+  vertex_array_t array;
+  indirect_draw_list_t list;
+} indirect_scene_t;
+
+// A static grid of arena shapes drawn from one indirect_draw_list, built
+// once; each draw finds its instances' data through base_instance
+static void* indirect_create(void) {
+  unsigned int program = bench_load_program("res/shaders/instanced.shader");
+  if (!program) return NULL;
+
+  indirect_scene_t* scene = (indirect_scene_t*)malloc(sizeof(indirect_scene_t));
+  scene->program = program;
+
+  scene->vertex_layout = vertex_buffer_layout_create();
+  vertex_buffer_layout_push_float(&scene->vertex_layout, 2);
+  vertex_buffer_layout_build(&scene->vertex_layout);
+  scene->instance_layout = scene_instance_layout();
+
+  mesh_arena_mesh_t shapes[SCENE_SHAPE_COUNT];
+  scene->arena = mesh_arena_create(
+      vertex_buffer_layout_get_stride(&scene->vertex_layout), 64, 64);
+  scene_add_shapes(&scene->arena, shapes);
+
+  // Cells take the shapes in turn; the list keeps each shape's instances
+  // together, so their data is grouped by shape too
+  scene_instance_t* data =
+      (scene_instance_t*)malloc(INSTANCES * sizeof(scene_instance_t));
+  scene->list = indirect_draw_list_create();
+  unsigned int per_shape = INSTANCES / SCENE_SHAPE_COUNT;
+  unsigned int random = 1;
+  for (unsigned int shape = 0; shape < SCENE_SHAPE_COUNT; shape++) {
+    unsigned int first =
+        indirect_draw_list_add(&scene->list, &shapes[shape], per_shape);
+    for (unsigned int i = 0; i < per_shape; i++) {
+      unsigned int cell = i * SCENE_SHAPE_COUNT + shape;
+      float cell_size = 2.0f / GRID_SIZE;
+      float x = -1.0f + (cell % GRID_SIZE + 0.5f) * cell_size;
+      float y = -1.0f + (cell / GRID_SIZE + 0.5f) * cell_size;
+      float color[4] = {bench_random_float(&random),
+                        bench_random_float(&random), 0.5f + 0.5f * shape,
+                        1.0f};
+      scene_instance_set(&data[first + i], x, y, cell_size * 0.45f,
+                         bench_random_float(&random) * 6.28f, color);
+    }
+  }
+  scene->instances =
+      vertex_buffer_create(data, INSTANCES * sizeof(scene_instance_t));
+  free(data);
+
+  scene->array = vertex_array_create();
+  vertex_array_set_format(&scene->array, &scene->vertex_layout, 0);
+  vertex_array_set_format(&scene->array, &scene->instance_layout, 1);
+  vertex_array_set_vertex_buffer(&scene->array, 0, &scene->arena.vertices,
+                                 &scene->vertex_layout, 0);
+  vertex_array_set_vertex_buffer(&scene->array, 1, &scene->instances,
+                                 &scene->instance_layout, 0);
+  return scene;
+}
+
+static void indirect_frame(void* state, unsigned int frame) {
+  indirect_scene_t* scene = (indirect_scene_t*)state;
+  (void)frame;  // Static
+
+  renderer_use_program(scene->program);
+  vertex_array_bind(&scene->array);
+  index_buffer_bind(&scene->arena.indices);
+  indirect_draw_list_draw(&scene->list, &scene->arena);
+}
+
+static void indirect_destroy(void* state) {
+  indirect_scene_t* scene = (indirect_scene_t*)state;
+
+  indirect_draw_stats_t stats = indirect_draw_list_get_stats(&scene->list);
+  printf("Last frame: %u draws in %u GL calls\n", stats.draws,
+         stats.gl_calls);
+
+  indirect_draw_list_destroy(&scene->list);
+  vertex_array_destroy(&scene->array);
+  vertex_buffer_destroy(&scene->instances);
+  mesh_arena_destroy(&scene->arena);
+  vertex_buffer_layout_destroy(&scene->instance_layout);
+  vertex_buffer_layout_destroy(&scene->vertex_layout);
+  renderer_forget_program(scene->program);
+  GLCall(glDeleteProgram(scene->program));
+  free(scene);
+}
+
+const scene_t scene_indirect = {
+    "indirect", "mesh_arena shapes from one indirect_draw_list",
+    indirect_create, indirect_frame, indirect_destroy};
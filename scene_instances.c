@@ -0,0 +1,99 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include "bench.h"
+#include "instance_stream.h"
+#include "mesh_arena.h"
+#include "renderer.h"
+#include "scene.h"
+#include "vertex_array.h"
+#include "vertex_buffer_layout.h"
+
+#define INSTANCES_PER_SHAPE 2000
+
+typedef struct instances_scene {
+  unsigned int program;
+  mesh_arena_t arena;
+  mesh_arena_mesh_t shapes[SCENE_SHAPE_COUNT];
+  vertex_buffer_layout_t vertex_layout;
+  vertex_buffer_layout_t instance_layout;
+  vertex_array_t array;
+  instance_stream_t stream;
+  scene_instance_t* instances;  // Rewritten every frame
+} instances_scene_t;
+
+// Spinning arena shapes whose transforms are streamed every frame through
+// an instance_stream, one instanced draw per shape
+static void* instances_create(void) {
+  unsigned int program = bench_load_program("res/shaders/instanced.shader");
+  if (!program) return NULL;
+
+  instances_scene_t* scene =
+      (instances_scene_t*)malloc(sizeof(instances_scene_t));
+  scene->program = program;
+
+  scene->vertex_layout = vertex_buffer_layout_create();
+  vertex_buffer_layout_push_float(&scene->vertex_layout, 2);
+  vertex_buffer_layout_build(&scene->vertex_layout);
+  scene->instance_layout = scene_instance_layout();
+
+  scene->arena = mesh_arena_create(
+      vertex_buffer_layout_get_stride(&scene->vertex_layout), 64, 64);
+  scene_add_shapes(&scene->arena, scene->shapes);
+
+  scene->array = vertex_array_create();
+  vertex_array_set_format(&scene->array, &scene->vertex_layout, 0);
+  vertex_array_set_format(&scene->array, &scene->instance_layout, 1);
+  vertex_array_set_vertex_buffer(&scene->array, 0, &scene->arena.vertices,
+                                 &scene->vertex_layout, 0);
+
+  scene->stream = instance_stream_create(
+      SCENE_SHAPE_COUNT * INSTANCES_PER_SHAPE * sizeof(scene_instance_t));
+  scene->instances = (scene_instance_t*)malloc(INSTANCES_PER_SHAPE *
+                                               sizeof(scene_instance_t));
+  return scene;
+}
+
+static void instances_frame(void* state, unsigned int frame) {
+  instances_scene_t* scene = (instances_scene_t*)state;
+
+  instance_stream_begin_frame(&scene->stream);
+  for (unsigned int shape = 0; shape < SCENE_SHAPE_COUNT; shape++) {
+    unsigned int random = 1 + shape;
+    for (unsigned int i = 0; i < INSTANCES_PER_SHAPE; i++) {
+      float x = bench_random_float(&random) * 2.0f - 1.0f;
+      float y = bench_random_float(&random) * 2.0f - 1.0f;
+      float spin = bench_random_float(&random) * 0.2f - 0.1f;
+      float color[4] = {0.3f + 0.35f * shape, bench_random_float(&random),
+                        bench_random_float(&random), 1.0f};
+      scene_instance_set(&scene->instances[i], x, y, 0.02f, spin * frame,
+                         color);
+    }
+    instance_stream_draw_mesh(&scene->stream, &scene->array, &scene->arena,
+                              &scene->shapes[shape], scene->program, 1,
+                              &scene->instance_layout, scene->instances,
+                              INSTANCES_PER_SHAPE);
+  }
+  instance_stream_end_frame(&scene->stream);
+}
+
+static void instances_destroy(void* state) {
+  instances_scene_t* scene = (instances_scene_t*)state;
+
+  instance_stream_stats_t stats = instance_stream_get_stats(&scene->stream);
+  printf("Last frame: %u instances in %u draws, %u dropped\n",
+         stats.instances, stats.draws, stats.dropped);
+
+  free(scene->instances);
+  instance_stream_destroy(&scene->stream);
+  vertex_array_destroy(&scene->array);
+  mesh_arena_destroy(&scene->arena);
+  vertex_buffer_layout_destroy(&scene->instance_layout);
+  vertex_buffer_layout_destroy(&scene->vertex_layout);
+  renderer_forget_program(scene->program);
+  GLCall(glDeleteProgram(scene->program));
+  free(scene);
+}
+
+const scene_t scene_instances = {
+    "instances", "instance_stream shapes from a mesh_arena, spinning",
+    instances_create, instances_frame, instances_destroy};
@@ -0,0 +1,251 @@
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "bench.h"
+#include "index_buffer.h"
+#include "renderer.h"
+#include "scene.h"
+#include "shader.h"
+#include "shader_preprocessor.h"
+#include "vertex_array.h"
+#include "vertex_buffer.h"
+#include "vertex_buffer_layout.h"
+#include "vertex_encode.h"
+
+#define RINGS 96  // Quads around the torus
+#define SIDES 48  // Quads around the tube
+#define VERTEX_COUNT ((RINGS + 1) * (SIDES + 1))
+#define INDEX_COUNT (RINGS * SIDES * 6)
+
+typedef enum quantized_format {
+  QUANTIZED_FLOAT,       // float position and normal
+  QUANTIZED_OCTAHEDRAL,  // half position, octahedral snorm16 normal
+  QUANTIZED_PACKED,      // half position, 2_10_10_10 normal
+  QUANTIZED_FORMAT_COUNT
+} quantized_format_t;
+
+static const char* const FORMAT_NAMES[QUANTIZED_FORMAT_COUNT] = {
+    "float", "half + octahedral", "half + 2_10_10_10"};
+
+static const char* const DEFINES[] = {"OCTAHEDRAL_NORMALS"};
+
+typedef struct quantized_scene {
+  shader_t shader;             // Normals as vec3
+  shader_t octahedral_shader;  // Normals decoded from octahedral
+  index_buffer_t ib;
+  vertex_buffer_layout_t layouts[QUANTIZED_FORMAT_COUNT];
+  vertex_buffer_t vbs[QUANTIZED_FORMAT_COUNT];
+  vertex_array_t arrays[QUANTIZED_FORMAT_COUNT];
+} quantized_scene_t;
+
+// Torus positions (xyzw, w = 1) and unit normals (xyzw, w = 0)
+static void create_torus(float* positions, float* normals) {
+  for (int ring = 0; ring <= RINGS; ring++) {
+    for (int side = 0; side <= SIDES; side++) {
+      float u = 6.28318531f * ring / RINGS, v = 6.28318531f * side / SIDES;
+      float* p = &positions[(ring * (SIDES + 1) + side) * 4];
+      float* n = &normals[(ring * (SIDES + 1) + side) * 4];
+      n[0] = cosf(v) * cosf(u);
+      n[1] = cosf(v) * sinf(u);
+      n[2] = sinf(v);
+      n[3] = 0.0f;
+      p[0] = 0.7f * cosf(u) + 0.3f * n[0];
+      p[1] = 0.7f * sinf(u) + 0.3f * n[1];
+      p[2] = 0.3f * n[2];
+      p[3] = 1.0f;
+    }
+  }
+}
+
+static index_buffer_t create_torus_indices(void) {
+  unsigned int* indices =
+      (unsigned int*)malloc(INDEX_COUNT * sizeof(unsigned int));
+  unsigned int k = 0;
+  for (unsigned int ring = 0; ring < RINGS; ring++) {
+    for (unsigned int side = 0; side < SIDES; side++) {
+      unsigned int a = ring * (SIDES + 1) + side, b = a + 1;
+      unsigned int c = a + SIDES + 1, d = c + 1;
+      indices[k++] = a;
+      indices[k++] = c;
+      indices[k++] = b;
+      indices[k++] = b;
+      indices[k++] = c;
+      indices[k++] = d;
+    }
+  }
+
+  index_buffer_t ib = index_buffer_create(indices, INDEX_COUNT);
+  free(indices);
+  return ib;
+}
+
+// Interleave per-vertex attributes of position_size and normal_size bytes
+static unsigned char* interleave(const void* positions,
+                                 unsigned int position_size,
+                                 const void* normals,
+                                 unsigned int normal_size) {
+  unsigned int stride = position_size + normal_size;
+  unsigned char* vertices = (unsigned char*)malloc(VERTEX_COUNT * stride);
+  for (unsigned int i = 0; i < VERTEX_COUNT; i++) {
+    memcpy(vertices + i * stride,
+           (const unsigned char*)positions + i * position_size,
+           position_size);
+    memcpy(vertices + i * stride + position_size,
+           (const unsigned char*)normals + i * normal_size, normal_size);
+  }
+  return vertices;
+}
+
+static void create_vertex_buffers(quantized_scene_t* scene) {
+  float* positions = (float*)malloc(VERTEX_COUNT * 4 * sizeof(float));
+  float* normals = (float*)malloc(VERTEX_COUNT * 4 * sizeof(float));
+  create_torus(positions, normals);
+
+  // Float: xyz of each, dropping w
+  float* position3 = (float*)malloc(VERTEX_COUNT * 3 * sizeof(float));
+  float* normal3 = (float*)malloc(VERTEX_COUNT * 3 * sizeof(float));
+  for (unsigned int i = 0; i < VERTEX_COUNT; i++) {
+    memcpy(&position3[i * 3], &positions[i * 4], 3 * sizeof(float));
+    memcpy(&normal3[i * 3], &normals[i * 4], 3 * sizeof(float));
+  }
+
+  // Four halves keep the position 4-byte aligned; w is ignored
+  unsigned short* halves =
+      (unsigned short*)malloc(VERTEX_COUNT * 4 * sizeof(unsigned short));
+  vertex_encode_half(halves, positions, VERTEX_COUNT * 4);
+  short* octahedral = (short*)malloc(VERTEX_COUNT * 2 * sizeof(short));
+  vertex_encode_octahedral(octahedral, normal3, VERTEX_COUNT);
+  unsigned int* packed =
+      (unsigned int*)malloc(VERTEX_COUNT * sizeof(unsigned int));
+  vertex_encode_int_2_10_10_10(packed, normals, VERTEX_COUNT);
+
+  unsigned char* vertices[QUANTIZED_FORMAT_COUNT];
+  vertices[QUANTIZED_FLOAT] =
+      interleave(position3, 3 * sizeof(float), normal3, 3 * sizeof(float));
+  vertices[QUANTIZED_OCTAHEDRAL] =
+      interleave(halves, 4 * sizeof(unsigned short), octahedral,
+                 2 * sizeof(short));
+  vertices[QUANTIZED_PACKED] = interleave(halves, 4 * sizeof(unsigned short),
+                                          packed, sizeof(unsigned int));
+
+  for (int format = 0; format < QUANTIZED_FORMAT_COUNT; format++) {
+    unsigned int stride =
+        vertex_buffer_layout_get_stride(&scene->layouts[format]);
+    scene->vbs[format] =
+        vertex_buffer_create(vertices[format], VERTEX_COUNT * stride);
+    free(vertices[format]);
+    printf("%-17s %2u bytes per vertex, %6u bytes\n", FORMAT_NAMES[format],
+           stride, VERTEX_COUNT * stride);
+  }
+
+  free(packed);
+  free(octahedral);
+  free(halves);
+  free(normal3);
+  free(position3);
+  free(normals);
+  free(positions);
+}
+
+static bool load_shader(shader_t* shader, uint32_t mask) {
+  shader_source_t source = shader_preprocess_load(
+      "res/shaders/quantized.shader", DEFINES, 1, mask, NULL);
+  unsigned int program =
+      source.stage_count ? shader_create_program(&source) : 0;
+  shader_source_destroy(&source);
+
+  if (!program) {
+    printf("Failed to build res/shaders/quantized.shader\n");
+    return false;
+  }
+  *shader = shader_create(program);
+  return true;
+}
+
+// The same spinning torus from a float vertex buffer and from two
+// quantized ones at half its size, side by side, so the normalization
+// flags, the 2_10_10_10_REV bit layout and the octahedral decode are all
+// drawn; the three should look alike
+static void* quantized_create(void) {
+  quantized_scene_t* scene =
+      (quantized_scene_t*)malloc(sizeof(quantized_scene_t));
+  if (!load_shader(&scene->shader, 0)) {
+    free(scene);
+    return NULL;
+  }
+  if (!load_shader(&scene->octahedral_shader, 1)) {
+    shader_destroy(&scene->shader);
+    free(scene);
+    return NULL;
+  }
+
+  for (int format = 0; format < QUANTIZED_FORMAT_COUNT; format++)
+    scene->layouts[format] = vertex_buffer_layout_create();
+  vertex_buffer_layout_push_float(&scene->layouts[QUANTIZED_FLOAT], 3);
+  vertex_buffer_layout_push_float(&scene->layouts[QUANTIZED_FLOAT], 3);
+  vertex_buffer_layout_push_half(&scene->layouts[QUANTIZED_OCTAHEDRAL], 4);
+  vertex_buffer_layout_push_octahedral(&scene->layouts[QUANTIZED_OCTAHEDRAL]);
+  vertex_buffer_layout_push_half(&scene->layouts[QUANTIZED_PACKED], 4);
+  vertex_buffer_layout_push_int_2_10_10_10(&scene->layouts[QUANTIZED_PACKED]);
+
+  scene->ib = create_torus_indices();
+  for (int format = 0; format < QUANTIZED_FORMAT_COUNT; format++)
+    vertex_buffer_layout_build(&scene->layouts[format]);
+  create_vertex_buffers(scene);
+
+  for (int format = 0; format < QUANTIZED_FORMAT_COUNT; format++) {
+    scene->arrays[format] = vertex_array_create();
+    vertex_array_add_buffer(&scene->arrays[format], &scene->vbs[format],
+                            &scene->layouts[format]);
+  }
+  return scene;
+}
+
+static void quantized_frame(void* state, unsigned int frame) {
+  quantized_scene_t* scene = (quantized_scene_t*)state;
+
+  GLCall(glEnable(GL_DEPTH_TEST));
+  GLCall(glClear(GL_DEPTH_BUFFER_BIT));
+
+  // Tilted towards the viewer and spinning about y; x squeezed for the
+  // 600x400 target
+  float spin = frame * 0.02f, tilt = 1.1f, scale = 0.3f;
+  float cy = cosf(spin), sy = sinf(spin), cx = cosf(tilt), sx = sinf(tilt);
+  float aspect = 400.0f / 600.0f;
+  for (int format = 0; format < QUANTIZED_FORMAT_COUNT; format++) {
+    // Columns of scale * Ry(spin) * Rx(tilt), then the translation
+    float model[16] = {scale * aspect * cy, 0.0f, scale * -sy, 0.0f,  //
+                       scale * aspect * sy * sx, scale * cx,
+                       scale * cy * sx, 0.0f,  //
+                       scale * aspect * sy * cx, scale * -sx,
+                       scale * cy * cx, 0.0f,  //
+                       (format - 1) * 0.62f, 0.0f, 0.0f, 1.0f};
+
+    shader_t* shader = format == QUANTIZED_OCTAHEDRAL
+                           ? &scene->octahedral_shader
+                           : &scene->shader;
+    shader_set_mat4(shader, "u_Model", model);
+    renderer_draw(&scene->arrays[format], &scene->ib, shader->m_renderer_id);
+  }
+
+  GLCall(glDisable(GL_DEPTH_TEST));
+}
+
+static void quantized_destroy(void* state) {
+  quantized_scene_t* scene = (quantized_scene_t*)state;
+
+  for (int format = 0; format < QUANTIZED_FORMAT_COUNT; format++) {
+    vertex_array_destroy(&scene->arrays[format]);
+    vertex_buffer_destroy(&scene->vbs[format]);
+    vertex_buffer_layout_destroy(&scene->layouts[format]);
+  }
+  index_buffer_destroy(&scene->ib);
+  shader_destroy(&scene->octahedral_shader);
+  shader_destroy(&scene->shader);
+  free(scene);
+}
+
+const scene_t scene_quantized = {
+    "quantized", "a torus from float and from quantized vertex formats",
+    quantized_create, quantized_frame, quantized_destroy};
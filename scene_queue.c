@@ -0,0 +1,129 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include "bench.h"
+#include "index_buffer.h"
+#include "render_queue.h"
+#include "renderer.h"
+#include "scene.h"
+#include "shader.h"
+#include "vertex_array_cache.h"
+#include "vertex_buffer.h"
+#include "vertex_buffer_layout.h"
+
+#define SHADERS 4
+#define MATERIALS 4
+#define MESHES 16
+#define COMMANDS 2000
+
+typedef struct queue_scene {
+  shader_t shaders[SHADERS];
+  vertex_buffer_layout_t layout;
+  vertex_buffer_t vbs[MESHES];
+  index_buffer_t ibs[MESHES];
+  vertex_array_cache_t cache;
+  vertex_array_t arrays[MESHES];
+  unsigned int textures[MATERIALS];
+  render_queue_t queue;
+} queue_scene_t;
+
+// Small triangles in random order through a render_queue, which sorts them
+// by shader (each its own colour), material and depth before drawing
+static void* queue_create(void) {
+  unsigned int programs[SHADERS];
+  for (unsigned int i = 0; i < SHADERS; i++) {
+    programs[i] = bench_load_program("res/shaders/basic.shader");
+    if (!programs[i]) {
+      for (unsigned int j = 0; j < i; j++) {
+        renderer_forget_program(programs[j]);
+        GLCall(glDeleteProgram(programs[j]));
+      }
+      return NULL;
+    }
+  }
+
+  queue_scene_t* scene = (queue_scene_t*)malloc(sizeof(queue_scene_t));
+  for (unsigned int i = 0; i < SHADERS; i++) {
+    scene->shaders[i] = shader_create(programs[i]);
+    shader_set_vec4(&scene->shaders[i], "u_Color", 0.25f * (i + 1), 0.3f,
+                    1.0f - 0.2f * i, 1.0f);
+  }
+
+  scene->layout = vertex_buffer_layout_create();
+  vertex_buffer_layout_push_float(&scene->layout, 2);
+  vertex_buffer_layout_build(&scene->layout);
+
+  // One triangle per mesh on a 4x4 grid, each in its own buffers
+  unsigned int indices[] = {0, 1, 2};
+  scene->cache = vertex_array_cache_create();
+  for (unsigned int i = 0; i < MESHES; i++) {
+    float x = -0.8f + 0.4f * (i % 4), y = -0.8f + 0.4f * (i / 4);
+    float triangle[] = {x, y, x + 0.2f, y, x + 0.1f, y + 0.2f};
+    scene->vbs[i] = vertex_buffer_create(triangle, sizeof(triangle));
+    scene->ibs[i] = index_buffer_create(indices, 3);
+    scene->arrays[i] = vertex_array_cache_get(&scene->cache, &scene->vbs[i],
+                                              &scene->layout, &scene->ibs[i]);
+  }
+
+  // basic.shader samples nothing; the textures only add state changes
+  GLCall(glGenTextures(MATERIALS, scene->textures));
+  for (unsigned int i = 0; i < MATERIALS; i++) {
+    unsigned char texel[4] = {(unsigned char)(i * 64), 0, 0, 255};
+    GLCall(glBindTexture(GL_TEXTURE_2D, scene->textures[i]));
+    GLCall(glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, 1, 1, 0, GL_RGBA,
+                        GL_UNSIGNED_BYTE, texel));
+  }
+
+  scene->queue = render_queue_create();
+  return scene;
+}
+
+static void queue_frame(void* state, unsigned int frame) {
+  queue_scene_t* scene = (queue_scene_t*)state;
+
+  // A new random order every frame, repeating every 64 frames
+  unsigned int random = 1 + frame % 64;
+  for (unsigned int i = 0; i < COMMANDS; i++) {
+    unsigned int shader = bench_random(&random) % SHADERS;
+    unsigned int material = bench_random(&random) % MATERIALS;
+    unsigned int mesh = bench_random(&random) % MESHES;
+    float depth = bench_random_float(&random);
+
+    render_command_t command;
+    command.key =
+        render_queue_make_key(0, false, shader, material, mesh, depth);
+    command.shader = scene->shaders[shader].m_renderer_id;
+    command.vertex_array = scene->arrays[mesh].m_renderer_id;
+    command.index_buffer = scene->ibs[mesh].m_renderer_id;
+    command.index_type = index_buffer_get_type(&scene->ibs[mesh]);
+    command.index_count = 3;
+    command.first_index = 0;
+    command.base_vertex = 0;
+    command.texture = scene->textures[material];
+    render_queue_submit(&scene->queue, &command);
+  }
+
+  render_queue_execute(&scene->queue);
+}
+
+static void queue_destroy(void* state) {
+  queue_scene_t* scene = (queue_scene_t*)state;
+
+  render_queue_stats_t stats = render_queue_get_stats(&scene->queue);
+  printf("Last frame: %u draws, %u shader, %u array, %u texture changes\n",
+         stats.draws, stats.shader_changes, stats.vertex_array_changes,
+         stats.texture_changes);
+
+  render_queue_destroy(&scene->queue);
+  GLCall(glDeleteTextures(MATERIALS, scene->textures));
+  vertex_array_cache_destroy(&scene->cache);
+  for (unsigned int i = 0; i < MESHES; i++) {
+    vertex_buffer_destroy(&scene->vbs[i]);
+    index_buffer_destroy(&scene->ibs[i]);
+  }
+  vertex_buffer_layout_destroy(&scene->layout);
+  for (unsigned int i = 0; i < SHADERS; i++) shader_destroy(&scene->shaders[i]);
+  free(scene);
+}
+
+const scene_t scene_queue = {"queue", "render_queue sorted triangles",
+                             queue_create, queue_frame, queue_destroy};
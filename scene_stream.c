@@ -0,0 +1,105 @@
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "bench.h"
+#include "renderer.h"
+#include "scene.h"
+#include "shader.h"
+#include "stream_buffer.h"
+#include "vertex_array.h"
+#include "vertex_buffer.h"
+#include "vertex_buffer_layout.h"
+
+#define RIBBONS 8
+#define SEGMENTS 256  // Quads per ribbon
+#define RIBBON_VERTICES (SEGMENTS * 6)
+
+typedef struct stream_scene {
+  shader_t shader;
+  vertex_buffer_layout_t layout;
+  vertex_array_t array;
+  stream_buffer_t buffer;
+} stream_scene_t;
+
+// Waving ribbons whose vertices are generated on the CPU every frame and
+// written straight into a stream_buffer, one allocation and draw each
+static void* stream_create(void) {
+  unsigned int program = bench_load_program("res/shaders/basic.shader");
+  if (!program) return NULL;
+
+  stream_scene_t* scene = (stream_scene_t*)malloc(sizeof(stream_scene_t));
+  scene->shader = shader_create(program);
+
+  scene->layout = vertex_buffer_layout_create();
+  vertex_buffer_layout_push_float(&scene->layout, 2);
+  vertex_buffer_layout_build(&scene->layout);
+
+  scene->array = vertex_array_create();
+  vertex_array_set_format(&scene->array, &scene->layout, 0);
+
+  scene->buffer = stream_buffer_create(
+      GL_ARRAY_BUFFER,
+      RIBBONS * RIBBON_VERTICES * vertex_buffer_layout_get_stride(
+                                      &scene->layout),
+      3);
+  return scene;
+}
+
+static void stream_frame(void* state, unsigned int frame) {
+  stream_scene_t* scene = (stream_scene_t*)state;
+  unsigned int stride = vertex_buffer_layout_get_stride(&scene->layout);
+
+  // The GL buffer seen as a vertex buffer for binding
+  vertex_buffer_t view;
+  view.m_renderer_id = scene->buffer.m_renderer_id;
+  view.m_size = scene->buffer.region_size * scene->buffer.region_count;
+  view.m_capacity = view.m_size;
+  view.m_usage = BUFFER_USAGE_STREAM;
+
+  stream_buffer_begin_frame(&scene->buffer);
+  for (unsigned int ribbon = 0; ribbon < RIBBONS; ribbon++) {
+    unsigned int offset;
+    float* vertices = (float*)stream_buffer_alloc(
+        &scene->buffer, RIBBON_VERTICES * stride, stride, &offset);
+    if (!vertices) break;
+
+    float center = -0.875f + ribbon * 0.25f;
+    float phase = frame * 0.05f + ribbon * 0.7f;
+    for (unsigned int segment = 0; segment < SEGMENTS; segment++) {
+      float x0 = -1.0f + 2.0f * segment / SEGMENTS;
+      float x1 = -1.0f + 2.0f * (segment + 1) / SEGMENTS;
+      float y0 = center + 0.08f * sinf(x0 * 6.0f + phase);
+      float y1 = center + 0.08f * sinf(x1 * 6.0f + phase);
+      float quad[12] = {x0, y0 - 0.05f, x1, y1 - 0.05f, x1, y1 + 0.05f,
+                        x1, y1 + 0.05f, x0, y0 + 0.05f, x0, y0 - 0.05f};
+      for (int i = 0; i < 12; i++) vertices[segment * 12 + i] = quad[i];
+    }
+    stream_buffer_flush(&scene->buffer);
+
+    shader_set_vec4(&scene->shader, "u_Color", 0.2f + 0.1f * ribbon, 0.8f,
+                    1.0f - 0.1f * ribbon, 1.0f);
+    vertex_array_set_vertex_buffer(&scene->array, 0, &view, &scene->layout,
+                                   offset);
+    vertex_array_bind(&scene->array);
+    GLCall(glDrawArrays(GL_TRIANGLES, 0, RIBBON_VERTICES));
+  }
+  stream_buffer_end_frame(&scene->buffer);
+}
+
+static void stream_destroy(void* state) {
+  stream_scene_t* scene = (stream_scene_t*)state;
+
+  printf("%s stream buffer: %llu bytes over %u frames, %u fence waits\n",
+         scene->buffer.persistent ? "Persistent" : "Orphaning",
+         scene->buffer.stats.bytes_allocated, scene->buffer.stats.frames,
+         scene->buffer.stats.fence_waits);
+
+  stream_buffer_destroy(&scene->buffer);
+  vertex_array_destroy(&scene->array);
+  vertex_buffer_layout_destroy(&scene->layout);
+  shader_destroy(&scene->shader);
+  free(scene);
+}
+
+const scene_t scene_stream = {"stream", "stream_buffer ribbons, rewritten",
+                              stream_create, stream_frame, stream_destroy};
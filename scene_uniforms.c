@@ -0,0 +1,146 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "bench.h"
+#include "index_buffer.h"
+#include "renderer.h"
+#include "scene.h"
+#include "uniform_buffer.h"
+#include "vertex_array.h"
+#include "vertex_buffer.h"
+#include "vertex_buffer_layout.h"
+
+#define GRID_SIZE 8  // Quads per row and column, each its own material
+
+typedef struct uniforms_scene {
+  unsigned int program;
+  vertex_buffer_t vb;
+  index_buffer_t ib;
+  vertex_buffer_layout_t layout;
+  vertex_array_t array;
+  uniform_block_layout_t frame_layout;
+  uniform_block_layout_t view_layout;
+  uniform_block_layout_t material_layout;
+  uniform_buffer_t frame_block;
+  uniform_buffer_t view_block;
+  uniform_ring_t materials;
+  unsigned char* block;  // CPU-side block contents, largest block's size
+} uniforms_scene_t;
+
+// A grid of spinning quads whose frame and view data come from
+// uniform_buffers and whose colours, offsets and sizes are per-draw
+// material blocks pushed through a uniform_ring
+static void* uniforms_create(void) {
+  unsigned int program =
+      bench_load_program("res/shaders/uniform_blocks.shader");
+  if (!program) return NULL;
+
+  uniforms_scene_t* scene = (uniforms_scene_t*)malloc(sizeof(uniforms_scene_t));
+  scene->program = program;
+
+  float quad[] = {-1.0f, -1.0f, 1.0f, -1.0f, 1.0f, 1.0f, -1.0f, 1.0f};
+  unsigned int indices[] = {0, 1, 2, 2, 3, 0};
+  scene->vb = vertex_buffer_create(quad, sizeof(quad));
+  scene->ib = index_buffer_create(indices, 6);
+  scene->layout = vertex_buffer_layout_create();
+  vertex_buffer_layout_push_float(&scene->layout, 2);
+  vertex_buffer_layout_build(&scene->layout);
+  scene->array = vertex_array_create();
+  vertex_array_add_buffer(&scene->array, &scene->vb, &scene->layout);
+
+  uniform_block_bind_program(program, "Frame", UNIFORM_BLOCK_FRAME);
+  uniform_block_bind_program(program, "View", UNIFORM_BLOCK_VIEW);
+  uniform_block_bind_program(program, "Material", UNIFORM_BLOCK_MATERIAL);
+  scene->frame_layout = uniform_block_layout_reflect(program, "Frame");
+  scene->view_layout = uniform_block_layout_reflect(program, "View");
+  scene->material_layout = uniform_block_layout_reflect(program, "Material");
+
+  scene->frame_block =
+      uniform_buffer_create(scene->frame_layout.size, UNIFORM_BLOCK_FRAME);
+  scene->view_block =
+      uniform_buffer_create(scene->view_layout.size, UNIFORM_BLOCK_VIEW);
+  // Room for every block at the largest usual offset alignment, plus a
+  // tail that keeps the size off a multiple of the alignment, so the later
+  // frame regions start unaligned unless the ring rounds them
+  scene->materials = uniform_ring_create(
+      GRID_SIZE * GRID_SIZE * (scene->material_layout.size + 256) + 100,
+      UNIFORM_BLOCK_MATERIAL);
+
+  unsigned int block_size = scene->frame_layout.size;
+  if (scene->view_layout.size > block_size)
+    block_size = scene->view_layout.size;
+  if (scene->material_layout.size > block_size)
+    block_size = scene->material_layout.size;
+  scene->block = (unsigned char*)calloc(1, block_size);
+  return scene;
+}
+
+static void uniforms_frame(void* state, unsigned int frame) {
+  uniforms_scene_t* scene = (uniforms_scene_t*)state;
+
+  float time = frame * 0.03f;
+  uniform_block_write(&scene->frame_layout, scene->block, "u_Time", &time, 1);
+  uniform_buffer_update(&scene->frame_block, scene->block);
+
+  // Square cells on the 600x400 target
+  float view_projection[16] = {400.0f / 600.0f, 0.0f, 0.0f, 0.0f,  //
+                               0.0f, 1.0f, 0.0f, 0.0f,             //
+                               0.0f, 0.0f, 1.0f, 0.0f,             //
+                               0.0f, 0.0f, 0.0f, 1.0f};
+  uniform_block_write(&scene->view_layout, scene->block, "u_ViewProjection",
+                      view_projection, 1);
+  uniform_buffer_update(&scene->view_block, scene->block);
+
+  uniform_ring_begin_frame(&scene->materials);
+  unsigned int random = 1;
+  for (unsigned int i = 0; i < GRID_SIZE * GRID_SIZE; i++) {
+    float cell_size = 2.0f / GRID_SIZE;
+    float color[4] = {bench_random_float(&random),
+                      bench_random_float(&random),
+                      bench_random_float(&random), 1.0f};
+    float offset[2] = {-1.0f + (i % GRID_SIZE + 0.5f) * cell_size,
+                       -1.0f + (i / GRID_SIZE + 0.5f) * cell_size};
+    float scale = cell_size * (0.2f + 0.2f * bench_random_float(&random));
+    uniform_block_write(&scene->material_layout, scene->block, "u_Color",
+                        color, 1);
+    uniform_block_write(&scene->material_layout, scene->block, "u_Offset",
+                        offset, 1);
+    uniform_block_write(&scene->material_layout, scene->block, "u_Scale",
+                        &scale, 1);
+
+    unsigned int block_offset;
+    if (!uniform_ring_push(&scene->materials, scene->block,
+                           scene->material_layout.size, &block_offset))
+      break;
+    uniform_ring_bind(&scene->materials, block_offset,
+                      scene->material_layout.size);
+    renderer_draw(&scene->array, &scene->ib, scene->program);
+  }
+  uniform_ring_end_frame(&scene->materials);
+}
+
+static void uniforms_destroy(void* state) {
+  uniforms_scene_t* scene = (uniforms_scene_t*)state;
+
+  printf("Last frame: %u material blocks, %u bytes\n",
+         scene->materials.stats.blocks, scene->materials.stats.bytes);
+
+  free(scene->block);
+  uniform_ring_destroy(&scene->materials);
+  uniform_buffer_destroy(&scene->view_block);
+  uniform_buffer_destroy(&scene->frame_block);
+  uniform_block_layout_destroy(&scene->material_layout);
+  uniform_block_layout_destroy(&scene->view_layout);
+  uniform_block_layout_destroy(&scene->frame_layout);
+  vertex_array_destroy(&scene->array);
+  vertex_buffer_layout_destroy(&scene->layout);
+  index_buffer_destroy(&scene->ib);
+  vertex_buffer_destroy(&scene->vb);
+  renderer_forget_program(scene->program);
+  GLCall(glDeleteProgram(scene->program));
+  free(scene);
+}
+
+const scene_t scene_uniforms = {
+    "uniforms", "uniform_buffer frame data, uniform_ring materials",
+    uniforms_create, uniforms_frame, uniforms_destroy};
@@ -0,0 +1,312 @@
+#include "shader.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "gl_ext.h"
+#include "hash.h"
+#include "renderer.h"
+
+static void print_shader_log(unsigned int id) {
+  int log_length;
+  GLCall(glGetShaderiv(id, GL_INFO_LOG_LENGTH, &log_length));
+  char* message = (char*)malloc(log_length > 0 ? log_length : 1);
+  message[0] = '\0';
+  GLCall(glGetShaderInfoLog(id, log_length, &log_length, message));
+  fprintf(stderr, "Failed to compile shader: %s\n", message);
+  free(message);
+}
+
+static void print_program_log(unsigned int program) {
+  int log_length;
+  GLCall(glGetProgramiv(program, GL_INFO_LOG_LENGTH, &log_length));
+  char* message = (char*)malloc(log_length > 0 ? log_length : 1);
+  message[0] = '\0';
+  GLCall(glGetProgramInfoLog(program, log_length, &log_length, message));
+  fprintf(stderr, "Failed to link program: %s\n", message);
+  free(message);
+}
+
+unsigned int shader_compile_stage(unsigned int type, const char* source,
+                                  int length) {
+  unsigned int id = glCreateShader(type);
+  GLCall(glShaderSource(id, 1, &source, &length));
+  GLCall(glCompileShader(id));
+
+  int result;
+  GLCall(glGetShaderiv(id, GL_COMPILE_STATUS, &result));
+  if (result == GL_FALSE) {
+    print_shader_log(id);
+    GLCall(glDeleteShader(id));
+    return 0;
+  }
+
+  return id;
+}
+
+shader_build_t shader_build_begin(unsigned int program,
+                                  const shader_source_t* source) {
+  shader_build_t build;
+  build.program = program;
+  build.shader_count = 0;
+  build.finished = false;
+  build.linked = false;
+
+  for (unsigned int i = 0;
+       i < source->stage_count && build.shader_count < SHADER_STAGE_COUNT;
+       i++) {
+    const shader_stage_source_t* stage = &source->stages[i];
+    const char* text = stage->source;
+    int length = (int)stage->length;
+
+    unsigned int id = glCreateShader(shader_stage_gl_type(stage->stage));
+    GLCall(glShaderSource(id, 1, &text, &length));
+    GLCall(glCompileShader(id));
+    GLCall(glAttachShader(program, id));
+    build.shaders[build.shader_count++] = id;
+  }
+
+  // Linking straight away is fine even if a stage failed, the link status
+  // reports it when the build is finished
+  if (build.shader_count > 0) {
+    GLCall(glLinkProgram(program));
+  }
+
+  return build;
+}
+
+bool shader_build_ready(const shader_build_t* build) {
+  if (build->finished) return true;
+  if (!gl_ext.parallel_shader_compile) return false;
+
+  int complete = GL_FALSE;
+  GLCall(glGetProgramiv(build->program, GL_COMPLETION_STATUS_KHR, &complete));
+  return complete == GL_TRUE;
+}
+
+bool shader_build_finish(shader_build_t* build) {
+  if (build->finished) return build->linked;
+
+  bool compiled = build->shader_count > 0;
+  for (unsigned int i = 0; i < build->shader_count; i++) {
+    int result;
+    GLCall(glGetShaderiv(build->shaders[i], GL_COMPILE_STATUS, &result));
+    if (result == GL_FALSE) {
+      print_shader_log(build->shaders[i]);
+      compiled = false;
+    }
+  }
+
+  int result = GL_FALSE;
+  if (compiled) {
+    GLCall(glGetProgramiv(build->program, GL_LINK_STATUS, &result));
+    if (result == GL_FALSE) print_program_log(build->program);
+  }
+
+  for (unsigned int i = 0; i < build->shader_count; i++) {
+    GLCall(glDetachShader(build->program, build->shaders[i]));
+    GLCall(glDeleteShader(build->shaders[i]));
+  }
+  build->shader_count = 0;
+
+  build->finished = true;
+  build->linked = result == GL_TRUE;
+  return build->linked;
+}
+
+bool shader_link_program(unsigned int program, const shader_source_t* source) {
+  shader_build_t build = shader_build_begin(program, source);
+  return shader_build_finish(&build);
+}
+
+unsigned int shader_create_program(const shader_source_t* source) {
+  unsigned int program = glCreateProgram();
+
+  if (!shader_link_program(program, source)) {
+    GLCall(glDeleteProgram(program));
+    return 0;
+  }
+
+  GLCall(glValidateProgram(program));
+  return program;
+}
+
+static unsigned int slot_for_hash(uint64_t hash, unsigned int capacity) {
+  return (unsigned int)hash & (capacity - 1);
+}
+
+shader_t shader_create(unsigned int program) {
+  shader_t shader;
+  shader.m_renderer_id = program;
+  shader.uniforms = NULL;
+  shader.uniform_count = 0;
+
+  GLint count = 0, max_length = 0;
+  GLCall(glGetProgramiv(program, GL_ACTIVE_UNIFORMS, &count));
+  GLCall(glGetProgramiv(program, GL_ACTIVE_UNIFORM_MAX_LENGTH, &max_length));
+  if (count > 0) {
+    shader.uniforms =
+        (shader_uniform_t*)malloc(count * sizeof(shader_uniform_t));
+  }
+
+  // Keep the table at most half full
+  shader.slots_capacity = 8;
+  while (shader.slots_capacity < (unsigned int)count * 2)
+    shader.slots_capacity *= 2;
+  shader.slots = (int*)malloc(shader.slots_capacity * sizeof(int));
+  for (unsigned int i = 0; i < shader.slots_capacity; i++) shader.slots[i] = -1;
+
+  char* name = (char*)malloc(max_length > 0 ? max_length : 1);
+  for (GLint i = 0; i < count; i++) {
+    GLsizei length = 0;
+    GLint size = 0;
+    GLenum type = 0;
+    GLCall(glGetActiveUniform(program, i, max_length, &length, &size, &type,
+                              name));
+
+    // Members of uniform blocks have no location
+    GLCall(int location = glGetUniformLocation(program, name));
+    if (location < 0) continue;
+
+    if (length > 3 && strcmp(name + length - 3, "[0]") == 0) {
+      length -= 3;
+      name[length] = '\0';
+    }
+
+    shader_uniform_t* uniform = &shader.uniforms[shader.uniform_count];
+    uniform->name = (char*)malloc(length + 1);
+    memcpy(uniform->name, name, length + 1);
+    uniform->hash = hash_string(uniform->name, HASH_SEED);
+    uniform->location = location;
+    uniform->type = type;
+    uniform->size = size;
+    uniform->has_value = false;
+
+    unsigned int slot = slot_for_hash(uniform->hash, shader.slots_capacity);
+    while (shader.slots[slot] != -1)
+      slot = (slot + 1) & (shader.slots_capacity - 1);
+    shader.slots[slot] = (int)shader.uniform_count;
+    shader.uniform_count++;
+  }
+  free(name);
+
+  return shader;
+}
+
+void shader_destroy(shader_t* shader) {
+  if (shader) {
+    for (unsigned int i = 0; i < shader->uniform_count; i++)
+      free(shader->uniforms[i].name);
+    free(shader->uniforms);
+    free(shader->slots);
+    shader->uniforms = NULL;
+    shader->slots = NULL;
+    shader->uniform_count = 0;
+
+    renderer_forget_program(shader->m_renderer_id);
+    GLCall(glDeleteProgram(shader->m_renderer_id));
+    shader->m_renderer_id = 0;
+  }
+}
+
+void shader_bind(const shader_t* shader) {
+  if (shader) {
+    renderer_use_program(shader->m_renderer_id);
+  }
+}
+
+shader_uniform_t* shader_find_uniform(const shader_t* shader,
+                                      const char* name) {
+  uint64_t hash = hash_string(name, HASH_SEED);
+  unsigned int mask = shader->slots_capacity - 1;
+
+  for (unsigned int slot = slot_for_hash(hash, shader->slots_capacity);
+       shader->slots[slot] != -1; slot = (slot + 1) & mask) {
+    shader_uniform_t* uniform = &shader->uniforms[shader->slots[slot]];
+    if (uniform->hash == hash && strcmp(uniform->name, name) == 0)
+      return uniform;
+  }
+  return NULL;
+}
+
+// Find the uniform and bind the program if value differs from what the
+// uniform holds. Returns NULL when there is nothing to upload.
+static shader_uniform_t* begin_upload(shader_t* shader, const char* name,
+                                      const void* value, size_t size) {
+  shader_uniform_t* uniform = shader_find_uniform(shader, name);
+  if (!uniform) return NULL;
+
+  bool cacheable = size <= SHADER_UNIFORM_CACHE_SIZE;
+  if (cacheable && uniform->has_value &&
+      memcmp(uniform->value, value, size) == 0) {
+    renderer_record_uniform_upload(false);
+    return NULL;
+  }
+
+  if (cacheable) {
+    memcpy(uniform->value, value, size);
+    uniform->has_value = true;
+  } else {
+    // The cached bytes no longer describe what GL holds
+    uniform->has_value = false;
+  }
+  renderer_record_uniform_upload(true);
+  renderer_use_program(shader->m_renderer_id);
+  return uniform;
+}
+
+void shader_set_int(shader_t* shader, const char* name, int value) {
+  shader_uniform_t* uniform = begin_upload(shader, name, &value, sizeof(value));
+  if (uniform) {
+    GLCall(glUniform1i(uniform->location, value));
+  }
+}
+
+void shader_set_int_array(shader_t* shader, const char* name,
+                          const int* values, int count) {
+  shader_uniform_t* uniform =
+      begin_upload(shader, name, values, count * sizeof(int));
+  if (uniform) {
+    GLCall(glUniform1iv(uniform->location, count, values));
+  }
+}
+
+void shader_set_float(shader_t* shader, const char* name, float value) {
+  shader_uniform_t* uniform = begin_upload(shader, name, &value, sizeof(value));
+  if (uniform) {
+    GLCall(glUniform1f(uniform->location, value));
+  }
+}
+
+void shader_set_vec2(shader_t* shader, const char* name, float x, float y) {
+  float value[2] = {x, y};
+  shader_uniform_t* uniform = begin_upload(shader, name, value, sizeof(value));
+  if (uniform) {
+    GLCall(glUniform2fv(uniform->location, 1, value));
+  }
+}
+
+void shader_set_vec3(shader_t* shader, const char* name, float x, float y,
+                     float z) {
+  float value[3] = {x, y, z};
+  shader_uniform_t* uniform = begin_upload(shader, name, value, sizeof(value));
+  if (uniform) {
+    GLCall(glUniform3fv(uniform->location, 1, value));
+  }
+}
+
+void shader_set_vec4(shader_t* shader, const char* name, float x, float y,
+                     float z, float w) {
+  float value[4] = {x, y, z, w};
+  shader_uniform_t* uniform = begin_upload(shader, name, value, sizeof(value));
+  if (uniform) {
+    GLCall(glUniform4fv(uniform->location, 1, value));
+  }
+}
+
+void shader_set_mat4(shader_t* shader, const char* name, const float* value) {
+  shader_uniform_t* uniform =
+      begin_upload(shader, name, value, 16 * sizeof(float));
+  if (uniform) {
+    GLCall(glUniformMatrix4fv(uniform->location, 1, GL_FALSE, value));
+  }
+}
@@ -0,0 +1,91 @@
+#pragma once
+#include <stdbool.h>
+#include <stdint.h>
+#include "shader_source.h"
+
+// An in-flight compile and link. Starting a build issues every compile and
+// the link without querying any status, so the driver can overlap the work
+// (on its own threads with KHR_parallel_shader_compile) with whatever the
+// caller does next. Only finishing the build waits.
+typedef struct shader_build {
+  unsigned int program;
+  unsigned int shaders[SHADER_STAGE_COUNT];
+  unsigned int shader_count;
+  bool finished;
+  bool linked;
+} shader_build_t;
+
+// Compile a single stage. Returns 0 and logs the info log on failure.
+unsigned int shader_compile_stage(unsigned int type, const char* source,
+                                  int length);
+
+// Start compiling every stage of source and linking them into program
+shader_build_t shader_build_begin(unsigned int program,
+                                  const shader_source_t* source);
+
+// Whether finishing the build would not block. Without
+// KHR_parallel_shader_compile there is no way to ask, so this stays false
+// until the build is finished.
+bool shader_build_ready(const shader_build_t* build);
+
+// Wait for the build, log compile and link errors and release the stage
+// objects. Returns true if the program linked. Safe to call repeatedly.
+bool shader_build_finish(shader_build_t* build);
+
+// Compile every stage of source, attach them to program and link it.
+// Returns false and logs the info log if any step failed.
+bool shader_link_program(unsigned int program, const shader_source_t* source);
+
+// Create a program from source. Returns 0 on failure.
+unsigned int shader_create_program(const shader_source_t* source);
+
+// Bytes of a uniform's last value kept to skip redundant uploads; enough
+// for a mat4. Larger arrays are always uploaded.
+#define SHADER_UNIFORM_CACHE_SIZE 64
+
+typedef struct shader_uniform {
+  char* name;  // Arrays are listed without the "[0]" suffix
+  uint64_t hash;
+  int location;
+  unsigned int type;  // GL_FLOAT_VEC4 etc.
+  int size;           // Array length, 1 for plain uniforms
+  bool has_value;
+  unsigned char value[SHADER_UNIFORM_CACHE_SIZE];
+} shader_uniform_t;
+
+// A linked program and its active uniforms, looked up by name through a
+// hash table instead of glGetUniformLocation. Setters bind the program
+// through the renderer cache and skip the upload when the uniform already
+// holds the value.
+typedef struct shader {
+  unsigned int m_renderer_id;
+  shader_uniform_t* uniforms;
+  unsigned int uniform_count;
+  int* slots;  // Open addressing table of uniform indices, -1 when empty
+  unsigned int slots_capacity;  // Power of two
+} shader_t;
+
+// Take ownership of a linked program and read its active uniforms
+shader_t shader_create(unsigned int program);
+
+// Delete the program
+void shader_destroy(shader_t* shader);
+
+void shader_bind(const shader_t* shader);
+
+// Uniform for name, or NULL if the program has no such active uniform
+shader_uniform_t* shader_find_uniform(const shader_t* shader,
+                                      const char* name);
+
+// Typed setters. Unknown names are ignored, like location -1 in GL.
+void shader_set_int(shader_t* shader, const char* name, int value);
+void shader_set_int_array(shader_t* shader, const char* name,
+                          const int* values, int count);
+void shader_set_float(shader_t* shader, const char* name, float value);
+void shader_set_vec2(shader_t* shader, const char* name, float x, float y);
+void shader_set_vec3(shader_t* shader, const char* name, float x, float y,
+                     float z);
+void shader_set_vec4(shader_t* shader, const char* name, float x, float y,
+                     float z, float w);
+// Column-major 4x4 matrix
+void shader_set_mat4(shader_t* shader, const char* name, const float* value);
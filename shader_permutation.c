@@ -0,0 +1,148 @@
+#include "shader_permutation.h"
+#include <stdlib.h>
+#include <string.h>
+#include "hash.h"
+#include "renderer.h"
+#include "shader_preprocessor.h"
+#include "shader_source.h"
+
+#define INITIAL_CAPACITY 16
+
+// Slot holding mask, or the empty slot where it would go
+static shader_permutation_variant_t* find_slot(
+    shader_permutation_variant_t* variants, unsigned int capacity,
+    uint32_t mask) {
+  unsigned int slot_mask = capacity - 1;
+  unsigned int slot =
+      (unsigned int)hash_bytes(&mask, sizeof(mask), HASH_SEED) & slot_mask;
+
+  while (variants[slot].used && variants[slot].mask != mask)
+    slot = (slot + 1) & slot_mask;
+  return &variants[slot];
+}
+
+static void rehash(shader_permutations_t* permutations,
+                   unsigned int capacity) {
+  shader_permutation_variant_t* variants =
+      (shader_permutation_variant_t*)calloc(
+          capacity, sizeof(shader_permutation_variant_t));
+
+  for (unsigned int i = 0; i < permutations->variants_capacity; i++) {
+    shader_permutation_variant_t* variant = &permutations->variants[i];
+    if (variant->used) *find_slot(variants, capacity, variant->mask) = *variant;
+  }
+
+  free(permutations->variants);
+  permutations->variants = variants;
+  permutations->variants_capacity = capacity;
+}
+
+shader_permutations_t shader_permutations_create(const char* filepath,
+                                                 const char* const* defines,
+                                                 unsigned int define_count) {
+  shader_permutations_t permutations;
+  memset(&permutations, 0, sizeof(permutations));
+
+  if (define_count > SHADER_PERMUTATION_MAX_DEFINES)
+    define_count = SHADER_PERMUTATION_MAX_DEFINES;
+  permutations.defines = defines;
+  permutations.define_count = define_count;
+
+  permutations.source =
+      shader_preprocess_includes(filepath, &permutations.source_size, NULL);
+  if (permutations.source) {
+    permutations.used_defines = shader_preprocess_used_defines(
+        permutations.source, permutations.source_size, defines, define_count);
+  }
+
+  permutations.variants = (shader_permutation_variant_t*)calloc(
+      INITIAL_CAPACITY, sizeof(shader_permutation_variant_t));
+  permutations.variants_capacity = INITIAL_CAPACITY;
+
+  return permutations;
+}
+
+void shader_permutations_destroy(shader_permutations_t* permutations) {
+  if (permutations) {
+    for (unsigned int i = 0; i < permutations->program_count; i++) {
+      unsigned int program = permutations->programs[i].program;
+      if (program) {
+        renderer_forget_program(program);
+        GLCall(glDeleteProgram(program));
+      }
+    }
+    free(permutations->programs);
+    free(permutations->variants);
+    free(permutations->source);
+    memset(permutations, 0, sizeof(*permutations));
+  }
+}
+
+// Build (or share) the program for a mask with unused bits already cleared.
+// Each used define injects its own line, so distinct masked masks always
+// expand to distinct sources and the masked mask alone identifies a program.
+static unsigned int build_program(shader_permutations_t* permutations,
+                                  program_cache_t* cache, uint32_t mask) {
+  // Linear: only reached for masks not seen before
+  for (unsigned int i = 0; i < permutations->program_count; i++) {
+    if (permutations->programs[i].mask == mask) {
+      permutations->stats.deduplicated++;
+      return permutations->programs[i].program;
+    }
+  }
+
+  size_t size = 0;
+  char* expanded = shader_preprocess_defines(
+      permutations->source, permutations->source_size, permutations->defines,
+      permutations->define_count, mask, &size);
+
+  // shader_source_parse takes ownership of expanded
+  shader_source_t source = shader_source_parse(expanded, size);
+  unsigned int program = program_cache_get(cache, &source);
+  shader_source_destroy(&source);
+  permutations->stats.built++;
+
+  if (permutations->program_count >= permutations->programs_capacity) {
+    permutations->programs_capacity = permutations->programs_capacity
+                                          ? permutations->programs_capacity * 2
+                                          : INITIAL_CAPACITY;
+    permutations->programs = (shader_permutation_program_t*)realloc(
+        permutations->programs, permutations->programs_capacity *
+                                    sizeof(shader_permutation_program_t));
+  }
+  shader_permutation_program_t* entry =
+      &permutations->programs[permutations->program_count++];
+  entry->mask = mask;
+  entry->program = program;
+  return program;
+}
+
+unsigned int shader_permutations_get(shader_permutations_t* permutations,
+                                     program_cache_t* cache, uint32_t mask) {
+  permutations->stats.requests++;
+  if (!permutations->source) return 0;
+
+  shader_permutation_variant_t* variant = find_slot(
+      permutations->variants, permutations->variants_capacity, mask);
+  if (variant->used) {
+    permutations->stats.hits++;
+    return variant->program;
+  }
+
+  unsigned int program =
+      build_program(permutations, cache, mask & permutations->used_defines);
+
+  // Keep the load factor at or below 3/4
+  if ((permutations->variant_count + 1) * 4 >
+      permutations->variants_capacity * 3) {
+    rehash(permutations, permutations->variants_capacity * 2);
+  }
+  variant = find_slot(permutations->variants, permutations->variants_capacity,
+                      mask);
+  variant->mask = mask;
+  variant->program = program;
+  variant->used = true;
+  permutations->variant_count++;
+
+  return program;
+}
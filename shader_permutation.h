@@ -0,0 +1,60 @@
+#pragma once
+#include <stdbool.h>
+#include <stdint.h>
+#include "program_cache.h"
+
+#define SHADER_PERMUTATION_MAX_DEFINES 32
+
+typedef struct shader_permutation_stats {
+  unsigned int requests;
+  unsigned int hits;          // Mask seen before
+  unsigned int deduplicated;  // New mask, same used bits as one built
+  unsigned int built;         // Programs fetched through the program cache
+} shader_permutation_stats_t;
+
+typedef struct shader_permutation_variant {
+  uint32_t mask;  // As requested
+  unsigned int program;
+  bool used;  // Programs may be 0 after a failed build, so flag occupancy
+} shader_permutation_variant_t;
+
+typedef struct shader_permutation_program {
+  uint32_t mask;  // Requested mask with unused bits cleared
+  unsigned int program;
+} shader_permutation_program_t;
+
+// The programs of one shader file for combinations of feature defines. The
+// file is read and its includes expanded once; each mask (bit i defines
+// defines[i]) then only injects defines. Bits for defines the file never
+// mentions are dropped before building and masks left with the same bits
+// share a program, so unused feature bits do not multiply compile time.
+// Builds go through a program_cache, so permutations compiled in an
+// earlier run load as binaries.
+typedef struct shader_permutations {
+  char* source;  // Includes expanded, owned
+  size_t source_size;
+  const char* const* defines;  // Not owned, must outlive the set
+  unsigned int define_count;
+  uint32_t used_defines;                   // Bits whose define is in source
+  shader_permutation_variant_t* variants;  // Open addressing on mask
+  unsigned int variant_count;
+  unsigned int variants_capacity;  // Power of two
+  shader_permutation_program_t* programs;
+  unsigned int program_count;
+  unsigned int programs_capacity;
+  shader_permutation_stats_t stats;
+} shader_permutations_t;
+
+// Load filepath with its includes. On failure the set has no source and
+// every permutation is 0.
+shader_permutations_t shader_permutations_create(const char* filepath,
+                                                 const char* const* defines,
+                                                 unsigned int define_count);
+
+// Deletes every program the set built
+void shader_permutations_destroy(shader_permutations_t* permutations);
+
+// Program for mask, building it through cache on first use. Returns 0 if
+// it failed to build. The program stays owned by the set.
+unsigned int shader_permutations_get(shader_permutations_t* permutations,
+                                     program_cache_t* cache, uint32_t mask);
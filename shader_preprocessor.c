@@ -0,0 +1,335 @@
+#include "shader_preprocessor.h"
+#include <stdarg.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "file_view.h"
+
+#define INITIAL_CAPACITY 4096
+// Paths are not normalised, so "../" cycles can defeat the include-once
+// check; this stops them
+#define MAX_INCLUDE_DEPTH 32
+
+// Growable output buffer
+typedef struct text {
+  char* data;
+  size_t length;
+  size_t capacity;
+} text_t;
+
+static void text_reserve(text_t* text, size_t extra) {
+  if (text->length + extra <= text->capacity) return;
+
+  size_t capacity = text->capacity ? text->capacity : INITIAL_CAPACITY;
+  while (capacity < text->length + extra) capacity *= 2;
+  text->data = (char*)realloc(text->data, capacity);
+  text->capacity = capacity;
+}
+
+static void text_append(text_t* text, const char* data, size_t size) {
+  text_reserve(text, size);
+  memcpy(text->data + text->length, data, size);
+  text->length += size;
+}
+
+static void text_appendf(text_t* text, const char* format, ...) {
+  char line[256];
+  va_list args;
+  va_start(args, format);
+  int length = vsnprintf(line, sizeof(line), format, args);
+  va_end(args);
+  if (length <= 0) return;
+  if (length >= (int)sizeof(line)) length = (int)sizeof(line) - 1;
+  text_append(text, line, (size_t)length);
+}
+
+static bool is_identifier_char(char c) {
+  return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') ||
+         (c >= '0' && c <= '9') || c == '_';
+}
+
+// If word follows p (after spaces and tabs) as a whole identifier, return a
+// pointer just past it, else NULL
+static const char* match_word(const char* p, const char* end,
+                              const char* word) {
+  while (p < end && (*p == ' ' || *p == '\t')) p++;
+
+  size_t length = strlen(word);
+  if ((size_t)(end - p) < length || memcmp(p, word, length) != 0) return NULL;
+  p += length;
+  if (p < end && is_identifier_char(*p)) return NULL;
+  return p;
+}
+
+// If the line is "#<directive>", return a pointer just past the directive
+// name, else NULL
+static const char* match_directive(const char* line, const char* line_end,
+                                   const char* directive) {
+  while (line < line_end && (*line == ' ' || *line == '\t')) line++;
+  if (line == line_end || *line != '#') return NULL;
+  return match_word(line + 1, line_end, directive);
+}
+
+typedef struct include_file {
+  char* path;
+  bool included;  // Already spliced into the current stage
+} include_file_t;
+
+typedef struct include_state {
+  text_t output;
+  include_file_t* files;  // Source string numbers index this list
+  unsigned int file_count;
+  unsigned int files_capacity;
+} include_state_t;
+
+static int find_file(const include_state_t* state, const char* path) {
+  for (unsigned int i = 0; i < state->file_count; i++) {
+    if (strcmp(state->files[i].path, path) == 0) return (int)i;
+  }
+  return -1;
+}
+
+static unsigned int add_file(include_state_t* state, const char* path) {
+  if (state->file_count >= state->files_capacity) {
+    state->files_capacity = state->files_capacity ? state->files_capacity * 2
+                                                  : 4;
+    state->files = (include_file_t*)realloc(
+        state->files, state->files_capacity * sizeof(include_file_t));
+  }
+
+  size_t length = strlen(path);
+  include_file_t* file = &state->files[state->file_count];
+  file->path = (char*)malloc(length + 1);
+  memcpy(file->path, path, length + 1);
+  file->included = true;
+  return state->file_count++;
+}
+
+// Path of name relative to the directory of the including file
+static char* resolve_path(const char* includer, const char* name,
+                          size_t name_length) {
+  const char* slash = strrchr(includer, '/');
+  const char* backslash = strrchr(includer, '\\');
+  if (backslash > slash) slash = backslash;
+  size_t directory_length = slash ? (size_t)(slash - includer) + 1 : 0;
+
+  char* path = (char*)malloc(directory_length + name_length + 1);
+  memcpy(path, includer, directory_length);
+  memcpy(path + directory_length, name, name_length);
+  path[directory_length + name_length] = '\0';
+  return path;
+}
+
+static bool expand_file(include_state_t* state, unsigned int file,
+                        unsigned int depth) {
+  if (depth > MAX_INCLUDE_DEPTH) {
+    fprintf(stderr, "%s: #include nested too deeply\n",
+            state->files[file].path);
+    return false;
+  }
+
+  file_view_t view = file_view_open(state->files[file].path);
+  if (!view.data) return false;
+
+  bool ok = true;
+  const char* end = view.data + view.size;
+  const char* line = view.data;
+  unsigned int line_number = 1;
+
+  while (line < end && ok) {
+    const char* newline = (const char*)memchr(line, '\n', end - line);
+    const char* line_end = newline ? newline : end;
+    const char* next_line = newline ? newline + 1 : end;
+
+    const char* argument;
+    if ((argument = match_directive(line, line_end, "include"))) {
+      while (argument < line_end && (*argument == ' ' || *argument == '\t'))
+        argument++;
+      char close = argument < line_end && *argument == '<' ? '>' : '"';
+      const char* name = argument + 1;
+      const char* name_end =
+          argument < line_end && (*argument == '"' || *argument == '<')
+              ? (const char*)memchr(name, close, line_end - name)
+              : NULL;
+
+      if (!name_end) {
+        fprintf(stderr, "%s:%u: malformed #include\n",
+                state->files[file].path, line_number);
+        ok = false;
+        break;
+      }
+
+      char* include_path =
+          resolve_path(state->files[file].path, name, name_end - name);
+      int included = find_file(state, include_path);
+      if (included < 0) {
+        included = (int)add_file(state, include_path);
+      } else if (state->files[included].included) {
+        included = -1;
+      }
+
+      if (included >= 0) {
+        state->files[included].included = true;
+        text_appendf(&state->output, "#line 1 %d\n", included);
+        ok = expand_file(state, included, depth + 1);
+        text_appendf(&state->output, "#line %u %u\n", line_number + 1, file);
+      } else {
+        text_append(&state->output, "\n", 1);  // Keep the line count
+      }
+      free(include_path);
+    } else if ((argument = match_directive(line, line_end, "pragma")) &&
+               match_word(argument, line_end, "once")) {
+      text_append(&state->output, "\n", 1);
+    } else {
+      // Stages compile separately, so each gets its own copy of includes
+      if (match_directive(line, line_end, "shader")) {
+        for (unsigned int i = 0; i < state->file_count; i++)
+          state->files[i].included = i == file;
+      }
+      text_append(&state->output, line, next_line - line);
+    }
+
+    line = next_line;
+    line_number++;
+  }
+
+  if (ok && view.size > 0 && end[-1] != '\n')
+    text_append(&state->output, "\n", 1);
+
+  file_view_close(&view);
+  return ok;
+}
+
+void shader_include_files_destroy(shader_include_files_t* files) {
+  if (files) {
+    for (unsigned int i = 0; i < files->count; i++) free(files->paths[i]);
+    free(files->paths);
+    files->paths = NULL;
+    files->count = 0;
+  }
+}
+
+char* shader_preprocess_includes(const char* filepath, size_t* size,
+                                 shader_include_files_t* files) {
+  include_state_t state;
+  memset(&state, 0, sizeof(state));
+
+  bool ok = expand_file(&state, add_file(&state, filepath), 0);
+
+  if (files) {
+    // Hand the paths over rather than copying them
+    files->paths = (char**)malloc(state.file_count * sizeof(char*));
+    files->count = state.file_count;
+    for (unsigned int i = 0; i < state.file_count; i++)
+      files->paths[i] = state.files[i].path;
+  } else {
+    for (unsigned int i = 0; i < state.file_count; i++)
+      free(state.files[i].path);
+  }
+  free(state.files);
+
+  if (!ok) {
+    free(state.output.data);
+    *size = 0;
+    return NULL;
+  }
+
+  *size = state.output.length;
+  return state.output.data ? state.output.data : (char*)malloc(1);
+}
+
+uint32_t shader_preprocess_used_defines(const char* source, size_t size,
+                                        const char* const* defines,
+                                        unsigned int define_count) {
+  uint32_t used = 0;
+  const char* end = source + size;
+  const char* p = source;
+
+  // One pass over identifiers, compared against every define name
+  while (p < end) {
+    if (!is_identifier_char(*p)) {
+      p++;
+      continue;
+    }
+    const char* start = p;
+    while (p < end && is_identifier_char(*p)) p++;
+
+    size_t length = p - start;
+    for (unsigned int i = 0; i < define_count && i < 32; i++) {
+      if (strlen(defines[i]) == length &&
+          memcmp(defines[i], start, length) == 0) {
+        used |= 1u << i;
+      }
+    }
+  }
+  return used;
+}
+
+char* shader_preprocess_defines(const char* source, size_t size,
+                                const char* const* defines,
+                                unsigned int define_count, uint32_t mask,
+                                size_t* result_size) {
+  text_t output;
+  memset(&output, 0, sizeof(output));
+  text_reserve(&output, size + 64);
+
+  const char* end = source + size;
+  const char* line = source;
+  unsigned int line_number = 1;
+  unsigned int file = 0;
+
+  while (line < end) {
+    const char* newline = (const char*)memchr(line, '\n', end - line);
+    const char* line_end = newline ? newline : end;
+    const char* next_line = newline ? newline + 1 : end;
+
+    text_append(&output, line, next_line - line);
+    if (!newline) text_append(&output, "\n", 1);
+
+    const char* argument;
+    if ((argument = match_directive(line, line_end, "line"))) {
+      // Follow the numbering set by shader_preprocess_includes
+      char* number_end;
+      unsigned long number = strtoul(argument, &number_end, 10);
+      line_number = (unsigned int)number - 1;
+      if (number_end < line_end) {
+        file = (unsigned int)strtoul(number_end, NULL, 10);
+      }
+    } else if (match_directive(line, line_end, "version")) {
+      for (unsigned int i = 0; i < define_count && i < 32; i++) {
+        if (mask & (1u << i))
+          text_appendf(&output, "#define %s 1\n", defines[i]);
+      }
+      text_appendf(&output, "#line %u %u\n", line_number + 1, file);
+    }
+
+    line = next_line;
+    line_number++;
+  }
+
+  *result_size = output.length;
+  return output.data;
+}
+
+shader_source_t shader_preprocess_load(const char* filepath,
+                                       const char* const* defines,
+                                       unsigned int define_count,
+                                       uint32_t mask,
+                                       shader_include_files_t* files) {
+  size_t size = 0;
+  char* text = shader_preprocess_includes(filepath, &size, files);
+
+  if (text && mask) {
+    size_t defined_size = 0;
+    char* defined = shader_preprocess_defines(text, size, defines,
+                                              define_count, mask,
+                                              &defined_size);
+    free(text);
+    text = defined;
+    size = defined_size;
+  }
+
+  // shader_source_parse takes ownership of text
+  return shader_source_parse(text, text ? size : 0);
+}
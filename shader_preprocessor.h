@@ -0,0 +1,53 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+#include "shader_source.h"
+
+// Text passes run on a shader file before shader_source_parse splits it
+// into stages. GLSL's own preprocessor still handles #if/#ifdef, so these
+// only add what it lacks.
+
+// Paths of the files an include expansion read, the top file first
+typedef struct shader_include_files {
+  char** paths;
+  unsigned int count;
+} shader_include_files_t;
+
+void shader_include_files_destroy(shader_include_files_t* files);
+
+// Read filepath and splice in every #include "path" (or <path>), resolved
+// relative to the including file. Each file is included at most once per
+// "#shader" stage, as if it started with #pragma once, which also stops
+// include cycles; "#pragma once" lines are dropped. #line directives
+// numbering the top file 0 and includes 1, 2, ... in order of first
+// inclusion keep compile errors pointing at the right file and line.
+// Includes must follow the stage's #version line. Returns a malloc'd
+// buffer (not NUL terminated), or NULL and logs if a file could not be
+// read. If files is not NULL it receives every path reached, also on
+// failure, e.g. to watch them for edits.
+char* shader_preprocess_includes(const char* filepath, size_t* size,
+                                 shader_include_files_t* files);
+
+// Bit i set when defines[i] appears as an identifier anywhere in source.
+// Permutation bits outside this mask cannot change the compiled program.
+uint32_t shader_preprocess_used_defines(const char* source, size_t size,
+                                        const char* const* defines,
+                                        unsigned int define_count);
+
+// Copy source inserting "#define <defines[i]> 1" after every #version line
+// for each bit i set in mask, followed by a #line directive so line numbers
+// stay those of the file. Returns a malloc'd buffer.
+char* shader_preprocess_defines(const char* source, size_t size,
+                                const char* const* defines,
+                                unsigned int define_count, uint32_t mask,
+                                size_t* result_size);
+
+// Expand filepath's includes, inject the defines selected by mask and split
+// the result into stages: shader_source_load for files using #include.
+// files as for shader_preprocess_includes. Returns a source with no stages
+// if a file could not be read.
+shader_source_t shader_preprocess_load(const char* filepath,
+                                       const char* const* defines,
+                                       unsigned int define_count,
+                                       uint32_t mask,
+                                       shader_include_files_t* files);
@@ -0,0 +1,148 @@
+#include "shader_reload.h"
+#include <stdlib.h>
+#include <string.h>
+#include "gl_ext.h"
+#include "renderer.h"
+#include "shader_preprocessor.h"
+#include "shader_source.h"
+#include "timer.h"
+
+// Add watches for files not watched yet. Includes can change with an edit,
+// so this runs after every expansion.
+static void watch_files(shader_reload_t* reload, file_watcher_t* watcher,
+                        const shader_include_files_t* files) {
+  for (unsigned int i = 0; i < files->count; i++) {
+    bool watched = false;
+    for (unsigned int j = 0; j < reload->watch_count && !watched; j++) {
+      watched = strcmp(watcher->watches[reload->watches[j]].path,
+                       files->paths[i]) == 0;
+    }
+    if (watched) continue;
+
+    if (reload->watch_count >= reload->watches_capacity) {
+      reload->watches_capacity =
+          reload->watches_capacity ? reload->watches_capacity * 2 : 4;
+      reload->watches = (unsigned int*)realloc(
+          reload->watches, reload->watches_capacity * sizeof(unsigned int));
+    }
+    reload->watches[reload->watch_count++] =
+        file_watcher_add(watcher, files->paths[i]);
+  }
+}
+
+// Expand includes and defines as the original build did, watching every
+// file read. Returns a source without stages if a file could not be read.
+static shader_source_t load_source(shader_reload_t* reload,
+                                   file_watcher_t* watcher) {
+  shader_include_files_t files = {NULL, 0};
+  shader_source_t source =
+      shader_preprocess_load(reload->path, reload->defines,
+                             reload->define_count, reload->define_mask,
+                             &files);
+  watch_files(reload, watcher, &files);
+  shader_include_files_destroy(&files);
+  return source;
+}
+
+shader_reload_t shader_reload_create(shader_t* shader,
+                                     file_watcher_t* watcher,
+                                     program_cache_t* cache, const char* path,
+                                     const char* const* defines,
+                                     unsigned int define_count,
+                                     uint32_t define_mask) {
+  shader_reload_t reload;
+  memset(&reload, 0, sizeof(reload));
+
+  size_t length = strlen(path);
+  reload.path = (char*)malloc(length + 1);
+  memcpy(reload.path, path, length + 1);
+  reload.shader = shader;
+  reload.cache = cache;
+  reload.defines = defines;
+  reload.define_count = define_count;
+  reload.define_mask = define_mask;
+
+  // Only to find the includes; the program is already built
+  shader_source_t source = load_source(&reload, watcher);
+  shader_source_destroy(&source);
+
+  return reload;
+}
+
+// Wait for the build in flight and delete its program
+static void abandon_build(shader_reload_t* reload) {
+  if (!reload->building) return;
+
+  unsigned int program = program_cache_finish(reload->cache, &reload->build);
+  if (program) {
+    GLCall(glDeleteProgram(program));
+  }
+  reload->building = false;
+}
+
+void shader_reload_destroy(shader_reload_t* reload) {
+  if (reload) {
+    abandon_build(reload);
+    free(reload->path);
+    free(reload->watches);
+    reload->path = NULL;
+    reload->watches = NULL;
+    reload->watch_count = 0;
+  }
+}
+
+static void start_build(shader_reload_t* reload, file_watcher_t* watcher) {
+  // An edit landing mid-build supersedes it
+  abandon_build(reload);
+
+  shader_source_t source = load_source(reload, watcher);
+  if (source.stage_count == 0) {
+    // Editors can leave the file briefly empty; the next write retries
+    reload->stats.failures++;
+    shader_source_destroy(&source);
+    return;
+  }
+
+  reload->build = program_cache_begin(reload->cache, &source);
+  shader_source_destroy(&source);
+  reload->building = true;
+  reload->start_time = timer_now();
+  reload->frames = 0;
+}
+
+bool shader_reload_update(shader_reload_t* reload, file_watcher_t* watcher) {
+  // Ask about every file so each one's flag is cleared
+  bool changed = false;
+  for (unsigned int i = 0; i < reload->watch_count; i++) {
+    if (file_watcher_changed(watcher, reload->watches[i])) changed = true;
+  }
+  if (changed) {
+    start_build(reload, watcher);
+    return false;
+  }
+
+  if (!reload->building) return false;
+  reload->frames++;
+
+  // Without the extension there is nothing to poll; finishing a frame
+  // later at least lets the driver start on the compile
+  if (gl_ext.parallel_shader_compile && !program_cache_ready(&reload->build))
+    return false;
+
+  reload->building = false;
+  unsigned int program = program_cache_finish(reload->cache, &reload->build);
+  if (!program) {
+    // Keep drawing with the old program; the build logged the errors
+    reload->stats.failures++;
+    return false;
+  }
+
+  shader_t shader = shader_create(program);
+  shader_destroy(reload->shader);
+  *reload->shader = shader;
+
+  reload->stats.reloads++;
+  reload->stats.last_ms = timer_elapsed_ms(reload->start_time);
+  reload->stats.last_frames = reload->frames;
+  return true;
+}
@@ -0,0 +1,57 @@
+#pragma once
+#include <stdbool.h>
+#include <stdint.h>
+#include "file_watcher.h"
+#include "program_cache.h"
+#include "shader.h"
+
+typedef struct shader_reload_stats {
+  unsigned int reloads;      // New programs swapped in
+  unsigned int failures;     // Edits that did not build; old program stays
+  double last_ms;            // From noticing the write to the swap
+  unsigned int last_frames;  // Frames the last build spanned
+} shader_reload_stats_t;
+
+// Rebuilds a shader from its file when the file or anything it includes is
+// written, without stalling the frame: the build is started in the frame
+// that notices the change and only waited for once
+// KHR_parallel_shader_compile reports it done (without it, in the next
+// frame, so the compile overlaps the GPU work already queued). The source
+// goes through the same include and define passes as the original build,
+// and the program through the program cache, so reverting an edit loads
+// the earlier binary. The program handle is swapped only if the new one
+// linked, and the uniform table is read again from the new program.
+typedef struct shader_reload {
+  shader_t* shader;        // Not owned, replaced in place
+  program_cache_t* cache;  // Not owned
+  char* path;
+  const char* const* defines;  // Not owned, must outlive the reload
+  unsigned int define_count;
+  uint32_t define_mask;   // Bit i injects defines[i]
+  unsigned int* watches;  // file_watcher ids of path and its includes
+  unsigned int watch_count;
+  unsigned int watches_capacity;
+  bool building;
+  program_cache_build_t build;
+  double start_time;
+  unsigned int frames;
+  shader_reload_stats_t stats;
+} shader_reload_t;
+
+// Watch path, the file shader was built from, and the files it includes.
+// defines and define_mask are those it was built with through
+// shader_preprocess_load; pass NULL and 0 for none.
+shader_reload_t shader_reload_create(shader_t* shader,
+                                     file_watcher_t* watcher,
+                                     program_cache_t* cache, const char* path,
+                                     const char* const* defines,
+                                     unsigned int define_count,
+                                     uint32_t define_mask);
+
+// Abandon any build in flight. The shader itself is left alone.
+void shader_reload_destroy(shader_reload_t* reload);
+
+// Call once per frame after file_watcher_poll. Returns true in the frame
+// the shader was replaced: uniform values, sampler units and block bindings
+// belong to the old program and must be set again.
+bool shader_reload_update(shader_reload_t* reload, file_watcher_t* watcher);
@@ -0,0 +1,154 @@
+#include "shader_source.h"
+#include <glad/glad.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifndef GL_COMPUTE_SHADER
+#define GL_COMPUTE_SHADER 0x91B9
+#endif
+
+#define INITIAL_CAPACITY 2  // vertex + fragment is the common case
+#define DIRECTIVE "#shader"
+#define DIRECTIVE_LENGTH (sizeof(DIRECTIVE) - 1)
+
+static const char* const STAGE_NAMES[SHADER_STAGE_COUNT] = {
+    "vertex", "fragment", "geometry", "compute"};
+
+static int is_space(char c) {
+  return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+}
+
+static int parse_stage_name(const char* name, size_t length,
+                            shader_stage_t* stage) {
+  for (int i = 0; i < SHADER_STAGE_COUNT; i++) {
+    if (strlen(STAGE_NAMES[i]) == length &&
+        memcmp(STAGE_NAMES[i], name, length) == 0) {
+      *stage = (shader_stage_t)i;
+      return 1;
+    }
+  }
+  return 0;
+}
+
+static void push_stage(shader_source_t* source, shader_stage_t stage,
+                       const char* start, const char* end) {
+  // Trim surrounding whitespace so the slice begins at #version
+  while (start < end && is_space(*start)) start++;
+  while (end > start && is_space(end[-1])) end--;
+
+  if (source->stage_count >= source->stages_capacity) {
+    source->stages_capacity *= 2;
+    source->stages = (shader_stage_source_t*)realloc(
+        source->stages,
+        source->stages_capacity * sizeof(shader_stage_source_t));
+  }
+
+  shader_stage_source_t* slice = &source->stages[source->stage_count++];
+  slice->stage = stage;
+  slice->source = start;
+  slice->length = (unsigned int)(end - start);
+}
+
+shader_source_t shader_source_parse_view(file_view_t view) {
+  shader_source_t source;
+  source.view = view;
+  source.stages = (shader_stage_source_t*)malloc(
+      INITIAL_CAPACITY * sizeof(shader_stage_source_t));
+  source.stage_count = 0;
+  source.stages_capacity = INITIAL_CAPACITY;
+
+  const char* end = view.data + view.size;
+  const char* line = view.data;
+  const char* section_start = NULL;  // NULL until the first known directive
+  shader_stage_t section_stage = SHADER_STAGE_VERTEX;
+
+  // Each byte is visited at most twice: once by memchr to find the end of
+  // its line and once more only if the line starts with a directive.
+  while (line < end) {
+    const char* newline = (const char*)memchr(line, '\n', end - line);
+    const char* line_end = newline ? newline : end;
+    const char* next_line = newline ? newline + 1 : end;
+
+    const char* p = line;
+    while (p < line_end && (*p == ' ' || *p == '\t')) p++;
+
+    if ((size_t)(line_end - p) > DIRECTIVE_LENGTH &&
+        memcmp(p, DIRECTIVE, DIRECTIVE_LENGTH) == 0 &&
+        (p[DIRECTIVE_LENGTH] == ' ' || p[DIRECTIVE_LENGTH] == '\t')) {
+      if (section_start) push_stage(&source, section_stage, section_start, line);
+
+      const char* name = p + DIRECTIVE_LENGTH;
+      while (name < line_end && (*name == ' ' || *name == '\t')) name++;
+      const char* name_end = name;
+      while (name_end < line_end && !is_space(*name_end)) name_end++;
+
+      if (parse_stage_name(name, name_end - name, &section_stage)) {
+        section_start = next_line;
+      } else {
+        fprintf(stderr, "Unknown shader stage: %.*s\n", (int)(name_end - name),
+                name);
+        section_start = NULL;
+      }
+    }
+
+    line = next_line;
+  }
+
+  if (section_start) push_stage(&source, section_stage, section_start, end);
+
+  return source;
+}
+
+shader_source_t shader_source_parse(char* buffer, size_t size) {
+  return shader_source_parse_view(file_view_from_buffer(buffer, size));
+}
+
+shader_source_t shader_source_load(const char* filepath) {
+  file_view_t view = file_view_open(filepath);
+  if (!view.data) {
+    shader_source_t empty = {view, NULL, 0, 0};
+    return empty;
+  }
+
+  return shader_source_parse_view(view);
+}
+
+void shader_source_destroy(shader_source_t* source) {
+  if (source) {
+    file_view_close(&source->view);
+    free(source->stages);
+    source->stages = NULL;
+    source->stage_count = 0;
+    source->stages_capacity = 0;
+  }
+}
+
+const shader_stage_source_t* shader_source_get_stage(
+    const shader_source_t* source, shader_stage_t stage) {
+  if (!source) return NULL;
+
+  for (unsigned int i = 0; i < source->stage_count; i++) {
+    if (source->stages[i].stage == stage) return &source->stages[i];
+  }
+  return NULL;
+}
+
+unsigned int shader_stage_gl_type(shader_stage_t stage) {
+  switch (stage) {
+    case SHADER_STAGE_VERTEX:
+      return GL_VERTEX_SHADER;
+    case SHADER_STAGE_FRAGMENT:
+      return GL_FRAGMENT_SHADER;
+    case SHADER_STAGE_GEOMETRY:
+      return GL_GEOMETRY_SHADER;
+    case SHADER_STAGE_COMPUTE:
+      return GL_COMPUTE_SHADER;
+    default:
+      return 0;
+  }
+}
+
+const char* shader_stage_name(shader_stage_t stage) {
+  return stage < SHADER_STAGE_COUNT ? STAGE_NAMES[stage] : "unknown";
+}
@@ -0,0 +1,48 @@
+#pragma once
+#include <stddef.h>
+#include "file_view.h"
+
+typedef enum shader_stage {
+  SHADER_STAGE_VERTEX,
+  SHADER_STAGE_FRAGMENT,
+  SHADER_STAGE_GEOMETRY,
+  SHADER_STAGE_COMPUTE,
+  SHADER_STAGE_COUNT
+} shader_stage_t;
+
+typedef struct shader_stage_source {
+  shader_stage_t stage;
+  const char* source;   // Points into the owning shader_source_t view
+  unsigned int length;  // Not NUL terminated, pass the length to GL
+} shader_stage_source_t;
+
+typedef struct shader_source {
+  file_view_t view;  // Whole file contents, mapped or owned
+  shader_stage_source_t* stages;
+  unsigned int stage_count;
+  unsigned int stages_capacity;
+} shader_source_t;
+
+// Open a shader file as a file_view and split it on "#shader <stage>" lines;
+// stages point straight into the view. On failure the returned source has
+// no data and no stages.
+shader_source_t shader_source_load(const char* filepath);
+
+// Split an in-memory shader file. Takes ownership of a malloc'd buffer.
+shader_source_t shader_source_parse(char* buffer, size_t size);
+
+// Split an open view, taking ownership of it
+shader_source_t shader_source_parse_view(file_view_t view);
+
+// Close the view and free the stage list
+void shader_source_destroy(shader_source_t* source);
+
+// First section for the given stage, or NULL if the file has none
+const shader_stage_source_t* shader_source_get_stage(
+    const shader_source_t* source, shader_stage_t stage);
+
+// GL shader type (e.g., GL_VERTEX_SHADER) for a stage
+unsigned int shader_stage_gl_type(shader_stage_t stage);
+
+// Name used after "#shader" for a stage
+const char* shader_stage_name(shader_stage_t stage);
@@ -0,0 +1,147 @@
+#include "stream_buffer.h"
+#include <stdlib.h>
+#include <string.h>
+#include "gl_ext.h"
+#include "renderer.h"
+#include "timer.h"
+
+#define FENCE_TIMEOUT_NS 1000000ull  // Re-check every millisecond
+
+stream_buffer_t stream_buffer_create(unsigned int target,
+                                     unsigned int region_size,
+                                     unsigned int region_count) {
+  stream_buffer_t buffer;
+  memset(&buffer, 0, sizeof(buffer));
+
+  if (region_count < 1) region_count = 1;
+  if (region_count > STREAM_BUFFER_MAX_REGIONS)
+    region_count = STREAM_BUFFER_MAX_REGIONS;
+
+  buffer.target = target;
+  buffer.region_size = region_size;
+  buffer.persistent = gl_ext.buffer_storage;
+  buffer.region_count = buffer.persistent ? region_count : 1;
+  // The first begin_frame wraps around to region 0
+  buffer.region = buffer.region_count - 1;
+
+  // Allocate through the copy target so the bound vertex array's element
+  // buffer is left alone
+  GLCall(glGenBuffers(1, &buffer.m_renderer_id));
+  GLCall(glBindBuffer(GL_COPY_WRITE_BUFFER, buffer.m_renderer_id));
+
+  if (buffer.persistent) {
+    GLbitfield flags =
+        GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+    GLsizeiptr total = (GLsizeiptr)region_size * buffer.region_count;
+    GLCall(glBufferStorage(GL_COPY_WRITE_BUFFER, total, NULL, flags));
+    GLCall(buffer.mapped = (unsigned char*)glMapBufferRange(
+               GL_COPY_WRITE_BUFFER, 0, total, flags));
+  } else {
+    GLCall(glBufferData(GL_COPY_WRITE_BUFFER, region_size, NULL,
+                        GL_STREAM_DRAW));
+    buffer.mapped = (unsigned char*)malloc(region_size);
+  }
+
+  return buffer;
+}
+
+void stream_buffer_destroy(stream_buffer_t* buffer) {
+  if (!buffer || !buffer->m_renderer_id) return;
+
+  for (unsigned int i = 0; i < STREAM_BUFFER_MAX_REGIONS; i++) {
+    if (buffer->fences[i]) {
+      GLCall(glDeleteSync(buffer->fences[i]));
+      buffer->fences[i] = NULL;
+    }
+  }
+
+  if (buffer->persistent) {
+    GLCall(glBindBuffer(GL_COPY_WRITE_BUFFER, buffer->m_renderer_id));
+    GLCall(glUnmapBuffer(GL_COPY_WRITE_BUFFER));
+  } else {
+    free(buffer->mapped);
+  }
+  buffer->mapped = NULL;
+
+  renderer_forget_buffer(buffer->m_renderer_id);
+  GLCall(glDeleteBuffers(1, &buffer->m_renderer_id));
+  buffer->m_renderer_id = 0;  // Set to 0 to mark as deleted
+}
+
+static void wait_for_region(stream_buffer_t* buffer, unsigned int region) {
+  GLsync fence = buffer->fences[region];
+  if (!fence) return;
+
+  GLCall(GLenum status = glClientWaitSync(fence, 0, 0));
+  if (status == GL_TIMEOUT_EXPIRED) {
+    double start = timer_now();
+    do {
+      GLCall(status = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT,
+                                       FENCE_TIMEOUT_NS));
+    } while (status == GL_TIMEOUT_EXPIRED);
+    buffer->stats.fence_waits++;
+    buffer->stats.fence_wait_ms += timer_elapsed_ms(start);
+  }
+
+  GLCall(glDeleteSync(fence));
+  buffer->fences[region] = NULL;
+}
+
+void stream_buffer_begin_frame(stream_buffer_t* buffer) {
+  buffer->region = (buffer->region + 1) % buffer->region_count;
+  buffer->offset = 0;
+  buffer->flushed = 0;
+  buffer->stats.frames++;
+
+  if (buffer->persistent) {
+    wait_for_region(buffer, buffer->region);
+  } else {
+    // Orphan: the driver hands us fresh storage while the GPU keeps reading
+    // last frame's
+    GLCall(glBindBuffer(GL_COPY_WRITE_BUFFER, buffer->m_renderer_id));
+    GLCall(glBufferData(GL_COPY_WRITE_BUFFER, buffer->region_size, NULL,
+                        GL_STREAM_DRAW));
+  }
+}
+
+void* stream_buffer_alloc(stream_buffer_t* buffer, unsigned int size,
+                          unsigned int alignment, unsigned int* offset) {
+  unsigned int start = buffer->offset;
+  if (alignment > 1) start = (start + alignment - 1) / alignment * alignment;
+
+  if (start > buffer->region_size || size > buffer->region_size - start)
+    return NULL;
+
+  buffer->offset = start + size;
+  buffer->stats.bytes_allocated += size;
+
+  unsigned int region_start =
+      buffer->persistent ? buffer->region * buffer->region_size : 0;
+  if (offset) *offset = region_start + start;
+  return buffer->mapped + region_start + start;
+}
+
+void stream_buffer_flush(stream_buffer_t* buffer) {
+  if (buffer->persistent || buffer->offset <= buffer->flushed) return;
+
+  GLCall(glBindBuffer(GL_COPY_WRITE_BUFFER, buffer->m_renderer_id));
+  GLCall(glBufferSubData(GL_COPY_WRITE_BUFFER, buffer->flushed,
+                         buffer->offset - buffer->flushed,
+                         buffer->mapped + buffer->flushed));
+  buffer->flushed = buffer->offset;
+}
+
+void stream_buffer_end_frame(stream_buffer_t* buffer) {
+  stream_buffer_flush(buffer);
+
+  if (buffer->persistent) {
+    GLCall(buffer->fences[buffer->region] =
+               glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0));
+  }
+}
+
+void stream_buffer_bind(const stream_buffer_t* buffer) {
+  if (buffer) {
+    renderer_bind_buffer(buffer->target, buffer->m_renderer_id);
+  }
+}
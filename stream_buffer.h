@@ -0,0 +1,61 @@
+#pragma once
+#include <glad/glad.h>
+#include <stdbool.h>
+
+#define STREAM_BUFFER_MAX_REGIONS 4
+
+// Upload counters since creation
+typedef struct stream_buffer_stats {
+  unsigned long long bytes_allocated;
+  unsigned int frames;
+  unsigned int fence_waits;  // Frames that had to wait on the GPU
+  double fence_wait_ms;
+} stream_buffer_stats_t;
+
+// A buffer for geometry rewritten every frame. With buffer storage it is one
+// persistently mapped, coherent allocation split into region_count frame
+// regions; a fence per region keeps the CPU from overwriting data the GPU
+// has not consumed yet. Without buffer storage it keeps a single region,
+// stages writes in system memory and orphans the GL buffer each frame.
+typedef struct stream_buffer {
+  unsigned int m_renderer_id;
+  unsigned int target;       // e.g. GL_ARRAY_BUFFER
+  unsigned int region_size;  // Bytes available per frame
+  unsigned int region_count;
+  unsigned int region;        // Region written this frame
+  unsigned int offset;        // Next free byte in the current region
+  unsigned int flushed;       // Staged bytes already uploaded (fallback)
+  unsigned char* mapped;      // Start of the persistent mapping or staging
+  bool persistent;
+  GLsync fences[STREAM_BUFFER_MAX_REGIONS];
+  stream_buffer_stats_t stats;
+} stream_buffer_t;
+
+// Create a stream buffer with region_size bytes per frame. region_count is
+// clamped to STREAM_BUFFER_MAX_REGIONS; 3 covers a typical frame queue.
+stream_buffer_t stream_buffer_create(unsigned int target,
+                                     unsigned int region_size,
+                                     unsigned int region_count);
+
+void stream_buffer_destroy(stream_buffer_t* buffer);
+
+// Move to the next frame's region, waiting for the GPU if it is still
+// reading it
+void stream_buffer_begin_frame(stream_buffer_t* buffer);
+
+// Reserve size bytes in this frame's region. Returns a write pointer and
+// stores the offset to draw from (in bytes, from the start of the GL buffer)
+// in *offset, or returns NULL if the region is full. alignment need not be a
+// power of two, so a vertex stride can be used directly.
+void* stream_buffer_alloc(stream_buffer_t* buffer, unsigned int size,
+                          unsigned int alignment, unsigned int* offset);
+
+// Make everything allocated so far visible to GL. Call before drawing from
+// it; a no-op for persistent mappings, which are coherent.
+void stream_buffer_flush(stream_buffer_t* buffer);
+
+// Fence this frame's region once its draws have been submitted
+void stream_buffer_end_frame(stream_buffer_t* buffer);
+
+// Bind to the buffer's target
+void stream_buffer_bind(const stream_buffer_t* buffer);
@@ -0,0 +1,26 @@
+#include "timer.h"
+
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+
+double timer_now(void) {
+  static LARGE_INTEGER frequency;
+  LARGE_INTEGER counter;
+
+  if (frequency.QuadPart == 0) QueryPerformanceFrequency(&frequency);
+  QueryPerformanceCounter(&counter);
+
+  return (double)counter.QuadPart / (double)frequency.QuadPart;
+}
+#else
+#include <time.h>
+
+double timer_now(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+#endif
+
+double timer_elapsed_ms(double start) { return (timer_now() - start) * 1000.0; }
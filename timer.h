@@ -0,0 +1,7 @@
+#pragma once
+
+// Monotonic wall clock in seconds, for measuring load and frame times.
+double timer_now(void);
+
+// Milliseconds elapsed since a value previously returned by timer_now().
+double timer_elapsed_ms(double start);
@@ -0,0 +1,290 @@
+#include "uniform_buffer.h"
+#include <stdlib.h>
+#include <string.h>
+#include "gpu_buffer.h"
+#include "hash.h"
+#include "renderer.h"
+
+#define FRAMES_IN_FLIGHT 3
+
+// Bytes of one column (or of the whole value, for non-matrices) and the
+// column count. Returns false for types it cannot lay out, e.g. doubles.
+static bool type_shape(unsigned int type, unsigned int* column_size,
+                       unsigned int* columns) {
+  *columns = 1;
+  switch (type) {
+    case GL_FLOAT:
+    case GL_INT:
+    case GL_UNSIGNED_INT:
+    case GL_BOOL:
+      *column_size = 4;
+      return true;
+    case GL_FLOAT_VEC2:
+    case GL_INT_VEC2:
+    case GL_UNSIGNED_INT_VEC2:
+    case GL_BOOL_VEC2:
+      *column_size = 8;
+      return true;
+    case GL_FLOAT_VEC3:
+    case GL_INT_VEC3:
+    case GL_UNSIGNED_INT_VEC3:
+    case GL_BOOL_VEC3:
+      *column_size = 12;
+      return true;
+    case GL_FLOAT_VEC4:
+    case GL_INT_VEC4:
+    case GL_UNSIGNED_INT_VEC4:
+    case GL_BOOL_VEC4:
+      *column_size = 16;
+      return true;
+    // matCxR: C columns of R floats
+    case GL_FLOAT_MAT2:
+      *column_size = 8;
+      *columns = 2;
+      return true;
+    case GL_FLOAT_MAT2x3:
+      *column_size = 12;
+      *columns = 2;
+      return true;
+    case GL_FLOAT_MAT2x4:
+      *column_size = 16;
+      *columns = 2;
+      return true;
+    case GL_FLOAT_MAT3x2:
+      *column_size = 8;
+      *columns = 3;
+      return true;
+    case GL_FLOAT_MAT3:
+      *column_size = 12;
+      *columns = 3;
+      return true;
+    case GL_FLOAT_MAT3x4:
+      *column_size = 16;
+      *columns = 3;
+      return true;
+    case GL_FLOAT_MAT4x2:
+      *column_size = 8;
+      *columns = 4;
+      return true;
+    case GL_FLOAT_MAT4x3:
+      *column_size = 12;
+      *columns = 4;
+      return true;
+    case GL_FLOAT_MAT4:
+      *column_size = 16;
+      *columns = 4;
+      return true;
+    default:
+      return false;
+  }
+}
+
+uniform_block_layout_t uniform_block_layout_reflect(unsigned int program,
+                                                    const char* block_name) {
+  uniform_block_layout_t layout;
+  layout.size = 0;
+  layout.members = NULL;
+  layout.member_count = 0;
+
+  GLCall(GLuint block = glGetUniformBlockIndex(program, block_name));
+  if (block == GL_INVALID_INDEX) return layout;
+
+  GLint size = 0, count = 0;
+  GLCall(glGetActiveUniformBlockiv(program, block, GL_UNIFORM_BLOCK_DATA_SIZE,
+                                   &size));
+  GLCall(glGetActiveUniformBlockiv(
+      program, block, GL_UNIFORM_BLOCK_ACTIVE_UNIFORMS, &count));
+  layout.size = (unsigned int)size;
+  if (count <= 0) return layout;
+
+  GLuint* indices = (GLuint*)malloc(count * sizeof(GLuint));
+  GLint* values = (GLint*)malloc(count * 5 * sizeof(GLint));
+  GLCall(glGetActiveUniformBlockiv(program, block,
+                                   GL_UNIFORM_BLOCK_ACTIVE_UNIFORM_INDICES,
+                                   (GLint*)indices));
+
+  const GLenum queries[5] = {GL_UNIFORM_TYPE, GL_UNIFORM_OFFSET,
+                             GL_UNIFORM_SIZE, GL_UNIFORM_ARRAY_STRIDE,
+                             GL_UNIFORM_MATRIX_STRIDE};
+  for (int query = 0; query < 5; query++) {
+    GLCall(glGetActiveUniformsiv(program, count, indices, queries[query],
+                                 values + query * count));
+  }
+
+  GLint max_length = 0;
+  GLCall(glGetProgramiv(program, GL_ACTIVE_UNIFORM_MAX_LENGTH, &max_length));
+  char* name = (char*)malloc(max_length > 0 ? max_length : 1);
+
+  layout.members = (uniform_block_member_t*)malloc(
+      count * sizeof(uniform_block_member_t));
+  for (int i = 0; i < count; i++) {
+    GLsizei length = 0;
+    GLCall(glGetActiveUniformName(program, indices[i], max_length, &length,
+                                  name));
+
+    // Instance-named blocks report members as "Block.member"
+    const char* member_name = name;
+    const char* dot = strrchr(name, '.');
+    if (dot) member_name = dot + 1;
+    size_t member_length = strlen(member_name);
+    if (member_length > 3 &&
+        strcmp(member_name + member_length - 3, "[0]") == 0) {
+      member_length -= 3;
+    }
+
+    uniform_block_member_t* member = &layout.members[layout.member_count++];
+    member->name = (char*)malloc(member_length + 1);
+    memcpy(member->name, member_name, member_length);
+    member->name[member_length] = '\0';
+    member->hash = hash_string(member->name, HASH_SEED);
+    member->type = (unsigned int)values[i];
+    member->offset = (unsigned int)values[count + i];
+    member->array_size = (unsigned int)values[2 * count + i];
+    member->array_stride = (unsigned int)values[3 * count + i];
+    member->matrix_stride = (unsigned int)values[4 * count + i];
+  }
+
+  free(name);
+  free(values);
+  free(indices);
+  return layout;
+}
+
+void uniform_block_layout_destroy(uniform_block_layout_t* layout) {
+  if (layout && layout->members) {
+    for (unsigned int i = 0; i < layout->member_count; i++)
+      free(layout->members[i].name);
+    free(layout->members);
+    layout->members = NULL;
+    layout->member_count = 0;
+    layout->size = 0;
+  }
+}
+
+bool uniform_block_bind_program(unsigned int program, const char* block_name,
+                                uniform_block_binding_t binding) {
+  GLCall(GLuint block = glGetUniformBlockIndex(program, block_name));
+  if (block == GL_INVALID_INDEX) return false;
+
+  GLCall(glUniformBlockBinding(program, block, binding));
+  return true;
+}
+
+bool uniform_block_write(const uniform_block_layout_t* layout, void* block,
+                         const char* name, const void* value,
+                         unsigned int count) {
+  uint64_t hash = hash_string(name, HASH_SEED);
+  const uniform_block_member_t* member = NULL;
+  for (unsigned int i = 0; i < layout->member_count; i++) {
+    if (layout->members[i].hash == hash &&
+        strcmp(layout->members[i].name, name) == 0) {
+      member = &layout->members[i];
+      break;
+    }
+  }
+  if (!member) return false;
+
+  if (count > member->array_size) count = member->array_size;
+
+  unsigned int column_size, columns;
+  if (!type_shape(member->type, &column_size, &columns)) return false;
+  unsigned int column_stride = member->matrix_stride ? member->matrix_stride
+                                                     : column_size;
+  unsigned int element_stride = member->array_stride
+                                    ? member->array_stride
+                                    : column_stride * columns;
+
+  unsigned char* destination = (unsigned char*)block + member->offset;
+  const unsigned char* source = (const unsigned char*)value;
+  for (unsigned int element = 0; element < count; element++) {
+    for (unsigned int column = 0; column < columns; column++) {
+      memcpy(destination + element * element_stride + column * column_stride,
+             source, column_size);
+      source += column_size;
+    }
+  }
+  return true;
+}
+
+uniform_buffer_t uniform_buffer_create(unsigned int size,
+                                       uniform_block_binding_t binding) {
+  uniform_buffer_t buffer;
+
+  buffer.m_renderer_id =
+      gpu_buffer_create(NULL, 0, size, BUFFER_USAGE_DYNAMIC);
+  buffer.size = size;
+  buffer.binding = binding;
+
+  return buffer;
+}
+
+void uniform_buffer_destroy(uniform_buffer_t* buffer) {
+  if (buffer) {
+    gpu_buffer_destroy(buffer->m_renderer_id);
+    buffer->m_renderer_id = 0;
+    buffer->size = 0;
+  }
+}
+
+void uniform_buffer_update(uniform_buffer_t* buffer, const void* data) {
+  gpu_buffer_orphan(buffer->m_renderer_id, buffer->size, BUFFER_USAGE_DYNAMIC);
+  gpu_buffer_update(buffer->m_renderer_id, 0, data, buffer->size);
+  renderer_bind_buffer_range(GL_UNIFORM_BUFFER, buffer->binding,
+                             buffer->m_renderer_id, 0, buffer->size);
+}
+
+uniform_ring_t uniform_ring_create(unsigned int frame_size,
+                                   uniform_block_binding_t binding) {
+  uniform_ring_t ring;
+
+  GLint alignment = 256;
+  GLCall(glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &alignment));
+  ring.alignment = alignment > 0 ? (unsigned int)alignment : 256;
+  // Blocks are aligned within a region, so every region must start aligned
+  frame_size = (frame_size + ring.alignment - 1) / ring.alignment *
+               ring.alignment;
+  ring.buffer =
+      stream_buffer_create(GL_UNIFORM_BUFFER, frame_size, FRAMES_IN_FLIGHT);
+  ring.binding = binding;
+  ring.stats.blocks = 0;
+  ring.stats.bytes = 0;
+
+  return ring;
+}
+
+void uniform_ring_destroy(uniform_ring_t* ring) {
+  if (ring) {
+    stream_buffer_destroy(&ring->buffer);
+  }
+}
+
+void uniform_ring_begin_frame(uniform_ring_t* ring) {
+  stream_buffer_begin_frame(&ring->buffer);
+  ring->stats.blocks = 0;
+  ring->stats.bytes = 0;
+}
+
+void uniform_ring_end_frame(uniform_ring_t* ring) {
+  stream_buffer_end_frame(&ring->buffer);
+}
+
+bool uniform_ring_push(uniform_ring_t* ring, const void* data,
+                       unsigned int size, unsigned int* offset) {
+  unsigned int used = ring->buffer.offset;
+  void* destination =
+      stream_buffer_alloc(&ring->buffer, size, ring->alignment, offset);
+  if (!destination) return false;
+
+  memcpy(destination, data, size);
+  ring->stats.blocks++;
+  ring->stats.bytes += ring->buffer.offset - used;
+  return true;
+}
+
+void uniform_ring_bind(uniform_ring_t* ring, unsigned int offset,
+                       unsigned int size) {
+  // Upload staged blocks first when the ring is not persistently mapped
+  stream_buffer_flush(&ring->buffer);
+  renderer_bind_buffer_range(GL_UNIFORM_BUFFER, ring->binding,
+                             ring->buffer.m_renderer_id, offset, size);
+}
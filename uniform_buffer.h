@@ -0,0 +1,102 @@
+#pragma once
+#include <stdbool.h>
+#include <stdint.h>
+#include "stream_buffer.h"
+
+// Binding points shared by every program, assigned with
+// uniform_block_bind_program. Frame and view blocks are bound once per
+// frame; material blocks are rebound per draw from a uniform_ring.
+typedef enum uniform_block_binding {
+  UNIFORM_BLOCK_FRAME = 0,
+  UNIFORM_BLOCK_VIEW = 1,
+  UNIFORM_BLOCK_MATERIAL = 2,
+  UNIFORM_BLOCK_BINDING_COUNT
+} uniform_block_binding_t;
+
+typedef struct uniform_block_member {
+  char* name;  // Block prefix and "[0]" stripped, e.g. "u_Color"
+  uint64_t hash;
+  unsigned int type;  // GL_FLOAT_VEC4 etc.
+  unsigned int offset;
+  unsigned int array_size;
+  unsigned int array_stride;   // 0 when not an array
+  unsigned int matrix_stride;  // Bytes between columns, 0 for non-matrices
+} uniform_block_member_t;
+
+// Member offsets and strides of a uniform block as the driver laid it out.
+// Declare blocks layout(std140) so the layout is the same in every program
+// that shares the block and blocks can be filled once for all of them.
+typedef struct uniform_block_layout {
+  unsigned int size;  // GL_UNIFORM_BLOCK_DATA_SIZE, 0 if not found
+  uniform_block_member_t* members;
+  unsigned int member_count;
+} uniform_block_layout_t;
+
+// Read the layout of block_name in a linked program
+uniform_block_layout_t uniform_block_layout_reflect(unsigned int program,
+                                                    const char* block_name);
+void uniform_block_layout_destroy(uniform_block_layout_t* layout);
+
+// Point the program's block_name at a binding point. Returns false if the
+// program has no such active block.
+bool uniform_block_bind_program(unsigned int program, const char* block_name,
+                                uniform_block_binding_t binding);
+
+// Write count elements of a member into CPU-side block memory of
+// layout->size bytes, following the reflected array and matrix strides
+// (a std140 float[4] takes 64 bytes, a mat3 three 16-byte columns). value
+// is tightly packed: count * element size, matrices column-major. Returns
+// false if the block has no such member, or one of a type this cannot
+// write (doubles and their vectors and matrices).
+bool uniform_block_write(const uniform_block_layout_t* layout, void* block,
+                         const char* name, const void* value,
+                         unsigned int count);
+
+// A block shared by every draw, e.g. per-frame or per-view data
+typedef struct uniform_buffer {
+  unsigned int m_renderer_id;
+  unsigned int size;
+  uniform_block_binding_t binding;
+} uniform_buffer_t;
+
+uniform_buffer_t uniform_buffer_create(unsigned int size,
+                                       uniform_block_binding_t binding);
+void uniform_buffer_destroy(uniform_buffer_t* buffer);
+
+// Replace the contents (orphaning the old storage) and bind the whole
+// buffer to its binding point
+void uniform_buffer_update(uniform_buffer_t* buffer, const void* data);
+
+typedef struct uniform_ring_stats {
+  unsigned int blocks;  // Blocks pushed this frame
+  unsigned int bytes;   // Including alignment padding
+} uniform_ring_stats_t;
+
+// Per-draw blocks (materials, objects) sub-allocated from a stream_buffer
+// each frame and bound with glBindBufferRange. Offsets honour
+// GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT.
+typedef struct uniform_ring {
+  stream_buffer_t buffer;
+  unsigned int alignment;
+  uniform_block_binding_t binding;
+  uniform_ring_stats_t stats;
+} uniform_ring_t;
+
+// frame_size bytes of blocks per frame, rounded up to the offset alignment
+uniform_ring_t uniform_ring_create(unsigned int frame_size,
+                                   uniform_block_binding_t binding);
+void uniform_ring_destroy(uniform_ring_t* ring);
+
+void uniform_ring_begin_frame(uniform_ring_t* ring);
+// Call once the frame's draws are submitted
+void uniform_ring_end_frame(uniform_ring_t* ring);
+
+// Copy a block into this frame's part of the ring. Push each material once
+// per frame and keep the offset for all of its draws. Returns false if the
+// frame is full.
+bool uniform_ring_push(uniform_ring_t* ring, const void* data,
+                       unsigned int size, unsigned int* offset);
+
+// Bind size bytes at offset to the ring's binding point
+void uniform_ring_bind(uniform_ring_t* ring, unsigned int offset,
+                       unsigned int size);
@@ -1,17 +1,22 @@
 #include "vertex_array.h"
 #include <stddef.h>
+#include "gl_ext.h"
 #include "renderer.h"
 
 vertex_array_t vertex_array_create(void) {
   vertex_array_t array;
 
   GLCall(glGenVertexArrays(1, &array.m_renderer_id));
+  array.attribute_count = 0;
+  for (unsigned int i = 0; i < VERTEX_ARRAY_MAX_BINDINGS; i++)
+    array.first_attributes[i] = 0;
 
   return array;
 }
 
 void vertex_array_destroy(vertex_array_t* array) {
   if (array) {
+    renderer_forget_vertex_array(array->m_renderer_id);
     GLCall(glDeleteVertexArrays(1, &array->m_renderer_id));
     array->m_renderer_id = 0;  // Set to 0 to mark as deleted
   }
@@ -19,13 +24,41 @@ void vertex_array_destroy(vertex_array_t* array) {
 
 void vertex_array_bind(vertex_array_t* array) {
   if (array) {
-    GLCall(glBindVertexArray(array->m_renderer_id));
+    renderer_bind_vertex_array(array->m_renderer_id);
   }
 }
 
 void vertex_array_unbind(void) {
   // Unbinding doesn't need the array pointer - just bind 0
-  GLCall(glBindVertexArray(0));
+  renderer_bind_vertex_array(0);
+}
+
+// Point the layout's attributes, from location first on, at the bound
+// GL_ARRAY_BUFFER starting offset bytes in
+static void set_attribute_pointers(unsigned int first,
+                                   const vertex_buffer_layout_t* layout,
+                                   unsigned int offset) {
+  unsigned int location = first;
+  for (unsigned int i = 0; i < vertex_buffer_layout_get_element_count(layout);
+       i++) {
+    vertex_buffer_element_t* element =
+        vertex_buffer_layout_get_element(layout, i);
+    if (!element) continue;
+
+    // Matrices take one location per column
+    unsigned int column_size = element->size / element->locations;
+    for (unsigned int column = 0; column < element->locations; column++) {
+      GLCall(glEnableVertexAttribArray(location));
+      GLCall(glVertexAttribPointer(
+          location, element->count, element->type, element->normalized,
+          vertex_buffer_layout_get_stride(layout),
+          (const void*)(size_t)(offset + column * column_size)));
+      GLCall(glVertexAttribDivisor(location, layout->divisor));
+      location++;
+    }
+
+    offset += element->size;
+  }
 }
 
 void vertex_array_add_buffer(vertex_array_t* array, vertex_buffer_t* vb,
@@ -37,6 +70,27 @@ void vertex_array_add_buffer(vertex_array_t* array, vertex_buffer_t* vb,
   vertex_array_bind(array);
   vertex_buffer_bind(vb);
 
+  set_attribute_pointers(array->attribute_count, layout, 0);
+  array->attribute_count += vertex_buffer_layout_get_location_count(layout);
+}
+
+void vertex_array_set_format(vertex_array_t* array,
+                             const vertex_buffer_layout_t* layout,
+                             unsigned int binding) {
+  if (!array || !layout || binding >= VERTEX_ARRAY_MAX_BINDINGS) {
+    return;
+  }
+
+  vertex_array_bind(array);
+
+  unsigned int first = array->attribute_count;
+  array->first_attributes[binding] = first;
+  array->attribute_count += vertex_buffer_layout_get_location_count(layout);
+
+  // Without vertex_attrib_binding the pointers are set up per buffer
+  if (!gl_ext.vertex_attrib_binding) return;
+
+  unsigned int location = first;
   unsigned int offset = 0;
   for (unsigned int i = 0; i < vertex_buffer_layout_get_element_count(layout);
        i++) {
@@ -44,11 +98,37 @@ void vertex_array_add_buffer(vertex_array_t* array, vertex_buffer_t* vb,
         vertex_buffer_layout_get_element(layout, i);
     if (!element) continue;
 
-    GLCall(glEnableVertexAttribArray(i));
-    GLCall(glVertexAttribPointer(
-        i, element->count, element->type, element->normalized,
-        vertex_buffer_layout_get_stride(layout), (const void*)(size_t)offset));
+    unsigned int column_size = element->size / element->locations;
+    for (unsigned int column = 0; column < element->locations; column++) {
+      GLCall(glEnableVertexAttribArray(location));
+      GLCall(glVertexAttribFormat(location, element->count, element->type,
+                                  element->normalized,
+                                  offset + column * column_size));
+      GLCall(glVertexAttribBinding(location, binding));
+      location++;
+    }
 
     offset += element->size;
   }
-}
\ No newline at end of file
+  GLCall(glVertexBindingDivisor(binding, layout->divisor));
+}
+
+void vertex_array_set_vertex_buffer(vertex_array_t* array,
+                                    unsigned int binding, vertex_buffer_t* vb,
+                                    const vertex_buffer_layout_t* layout,
+                                    unsigned int offset) {
+  if (!array || !vb || !layout || binding >= VERTEX_ARRAY_MAX_BINDINGS) {
+    return;
+  }
+
+  vertex_array_bind(array);
+
+  if (gl_ext.vertex_attrib_binding) {
+    renderer_bind_vertex_buffer(binding, vb->m_renderer_id, offset,
+                                vertex_buffer_layout_get_stride(layout));
+    return;
+  }
+
+  vertex_buffer_bind(vb);
+  set_attribute_pointers(array->first_attributes[binding], layout, offset);
+}
@@ -3,8 +3,13 @@
 #include "vertex_buffer.h"
 #include "vertex_buffer_layout.h"
 
+#define VERTEX_ARRAY_MAX_BINDINGS 4
+
 typedef struct vertex_array {
   unsigned int m_renderer_id;
+  unsigned int attribute_count;  // Next free attribute location
+  // First attribute location of each binding point's format
+  unsigned int first_attributes[VERTEX_ARRAY_MAX_BINDINGS];
 } vertex_array_t;
 
 // Create a new vertex array
@@ -19,6 +24,27 @@ void vertex_array_bind(vertex_array_t* array);
 // Unbind any vertex array
 void vertex_array_unbind(void);
 
-// Add a vertex buffer with a specific layout to this vertex array
+// Add a vertex buffer with a specific layout to this vertex array. Its
+// attributes take the next free locations, so a per-vertex buffer followed
+// by a per-instance buffer (layout divisor 1) gets locations 0..n-1 and
+// n..m-1 in that order.
 void vertex_array_add_buffer(vertex_array_t* array, vertex_buffer_t* vb,
-                             const vertex_buffer_layout_t* layout);
\ No newline at end of file
+                             const vertex_buffer_layout_t* layout);
+// Separate format and buffer binding, for one vertex array per layout that
+// many meshes share. With vertex_attrib_binding (GL 4.3) the format is set
+// once and switching meshes only rebinds the buffer and offset; without it
+// set_vertex_buffer re-specifies the attribute pointers, which still saves
+// the vertex array switch.
+
+// Describe the layout's attributes as sourced from the given binding point,
+// taking the next free locations like vertex_array_add_buffer
+void vertex_array_set_format(vertex_array_t* array,
+                             const vertex_buffer_layout_t* layout,
+                             unsigned int binding);
+
+// Source a binding point from vb, starting offset bytes in. The layout must
+// be the one passed to vertex_array_set_format.
+void vertex_array_set_vertex_buffer(vertex_array_t* array,
+                                    unsigned int binding, vertex_buffer_t* vb,
+                                    const vertex_buffer_layout_t* layout,
+                                    unsigned int offset);
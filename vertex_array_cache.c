@@ -0,0 +1,145 @@
+#include "vertex_array_cache.h"
+#include <stdlib.h>
+#include "hash.h"
+#include "renderer.h"
+
+#define INITIAL_CAPACITY 16
+
+static uint64_t entry_hash(uint64_t layout_hash, unsigned int vertex_buffer,
+                           unsigned int index_buffer) {
+  uint64_t hash = hash_bytes(&layout_hash, sizeof(layout_hash), HASH_SEED);
+  hash = hash_bytes(&vertex_buffer, sizeof(vertex_buffer), hash);
+  return hash_bytes(&index_buffer, sizeof(index_buffer), hash);
+}
+
+// Slot holding the tuple, or the empty slot where it would go
+static vertex_array_cache_entry_t* find_slot(
+    vertex_array_cache_entry_t* entries, unsigned int capacity,
+    const vertex_buffer_layout_t* layout, unsigned int vertex_buffer,
+    unsigned int index_buffer) {
+  unsigned int mask = capacity - 1;
+  unsigned int slot =
+      (unsigned int)entry_hash(layout->hash, vertex_buffer, index_buffer) &
+      mask;
+
+  while (entries[slot].array.m_renderer_id != 0) {
+    vertex_array_cache_entry_t* entry = &entries[slot];
+    if (entry->vertex_buffer == vertex_buffer &&
+        entry->index_buffer == index_buffer &&
+        vertex_buffer_layout_equal(&entry->layout, layout)) {
+      break;
+    }
+    slot = (slot + 1) & mask;
+  }
+  return &entries[slot];
+}
+
+// Re-insert every entry into a table of the given capacity
+static void rehash(vertex_array_cache_t* cache, unsigned int capacity) {
+  vertex_array_cache_entry_t* entries = (vertex_array_cache_entry_t*)calloc(
+      capacity, sizeof(vertex_array_cache_entry_t));
+
+  for (unsigned int i = 0; i < cache->entries_capacity; i++) {
+    vertex_array_cache_entry_t* entry = &cache->entries[i];
+    if (entry->array.m_renderer_id == 0) continue;
+    *find_slot(entries, capacity, &entry->layout, entry->vertex_buffer,
+               entry->index_buffer) = *entry;
+  }
+
+  free(cache->entries);
+  cache->entries = entries;
+  cache->entries_capacity = capacity;
+}
+
+vertex_array_cache_t vertex_array_cache_create(void) {
+  vertex_array_cache_t cache;
+
+  cache.entries = (vertex_array_cache_entry_t*)calloc(
+      INITIAL_CAPACITY, sizeof(vertex_array_cache_entry_t));
+  cache.entry_count = 0;
+  cache.entries_capacity = INITIAL_CAPACITY;
+  cache.stats.hits = 0;
+  cache.stats.misses = 0;
+  cache.stats.vertex_arrays = 0;
+
+  return cache;
+}
+
+void vertex_array_cache_destroy(vertex_array_cache_t* cache) {
+  if (cache && cache->entries) {
+    for (unsigned int i = 0; i < cache->entries_capacity; i++) {
+      if (cache->entries[i].array.m_renderer_id != 0) {
+        vertex_array_destroy(&cache->entries[i].array);
+        vertex_buffer_layout_destroy(&cache->entries[i].layout);
+      }
+    }
+    free(cache->entries);
+    cache->entries = NULL;
+    cache->entry_count = 0;
+    cache->entries_capacity = 0;
+  }
+}
+
+vertex_array_t vertex_array_cache_get(vertex_array_cache_t* cache,
+                                      vertex_buffer_t* vb,
+                                      const vertex_buffer_layout_t* layout,
+                                      index_buffer_t* ib) {
+  ASSERT(layout->built);
+  unsigned int index_buffer = ib ? ib->m_renderer_id : 0;
+
+  vertex_array_cache_entry_t* entry =
+      find_slot(cache->entries, cache->entries_capacity, layout,
+                vb->m_renderer_id, index_buffer);
+  if (entry->array.m_renderer_id != 0) {
+    cache->stats.hits++;
+    return entry->array;
+  }
+
+  // Keep the load factor under 3/4 so probes stay short
+  if ((cache->entry_count + 1) * 4 > cache->entries_capacity * 3) {
+    rehash(cache, cache->entries_capacity * 2);
+    entry = find_slot(cache->entries, cache->entries_capacity, layout,
+                      vb->m_renderer_id, index_buffer);
+  }
+
+  vertex_array_t array = vertex_array_create();
+  vertex_array_add_buffer(&array, vb, layout);
+  // The element buffer binding is part of the vertex array's state
+  if (ib) index_buffer_bind(ib);
+
+  entry->layout = vertex_buffer_layout_copy(layout);
+  entry->vertex_buffer = vb->m_renderer_id;
+  entry->index_buffer = index_buffer;
+  entry->array = array;
+  cache->entry_count++;
+  cache->stats.misses++;
+  cache->stats.vertex_arrays = cache->entry_count;
+
+  return array;
+}
+
+void vertex_array_cache_forget_buffer(vertex_array_cache_t* cache,
+                                      unsigned int buffer) {
+  if (buffer == 0) return;
+
+  bool removed = false;
+  for (unsigned int i = 0; i < cache->entries_capacity; i++) {
+    vertex_array_cache_entry_t* entry = &cache->entries[i];
+    if (entry->array.m_renderer_id == 0) continue;
+    if (entry->vertex_buffer == buffer || entry->index_buffer == buffer) {
+      vertex_array_destroy(&entry->array);
+      vertex_buffer_layout_destroy(&entry->layout);
+      cache->entry_count--;
+      removed = true;
+    }
+  }
+
+  // Emptied slots would break probe chains, so rebuild them
+  if (removed) rehash(cache, cache->entries_capacity);
+  cache->stats.vertex_arrays = cache->entry_count;
+}
+
+vertex_array_cache_stats_t vertex_array_cache_get_stats(
+    const vertex_array_cache_t* cache) {
+  return cache->stats;
+}
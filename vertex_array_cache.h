@@ -0,0 +1,50 @@
+#pragma once
+#include <stdint.h>
+#include "index_buffer.h"
+#include "vertex_array.h"
+#include "vertex_buffer.h"
+#include "vertex_buffer_layout.h"
+
+typedef struct vertex_array_cache_entry {
+  vertex_buffer_layout_t layout;  // Copy, compared on hash matches
+  unsigned int vertex_buffer;
+  unsigned int index_buffer;
+  vertex_array_t array;  // m_renderer_id 0 marks an empty slot
+} vertex_array_cache_entry_t;
+
+typedef struct vertex_array_cache_stats {
+  unsigned int hits;
+  unsigned int misses;  // Vertex arrays created and set up
+  unsigned int vertex_arrays;
+} vertex_array_cache_stats_t;
+
+// Hands out one vertex array per (layout, vertex buffer, index buffer), so
+// meshes that share buffers and a format share the vertex array and its
+// attribute setup. Open addressing hash table, linear probing.
+typedef struct vertex_array_cache {
+  vertex_array_cache_entry_t* entries;
+  unsigned int entry_count;
+  unsigned int entries_capacity;  // Power of two
+  vertex_array_cache_stats_t stats;
+} vertex_array_cache_t;
+
+vertex_array_cache_t vertex_array_cache_create(void);
+
+// Deletes every vertex array the cache created
+void vertex_array_cache_destroy(vertex_array_cache_t* cache);
+
+// Return the vertex array for the tuple, creating it on first use. The
+// layout must be built. ib may be NULL for non-indexed draws. The array
+// stays owned by the cache.
+vertex_array_t vertex_array_cache_get(vertex_array_cache_t* cache,
+                                      vertex_buffer_t* vb,
+                                      const vertex_buffer_layout_t* layout,
+                                      index_buffer_t* ib);
+
+// Delete the vertex arrays referencing a buffer. Call before destroying a
+// vertex or index buffer, since GL reuses the name.
+void vertex_array_cache_forget_buffer(vertex_array_cache_t* cache,
+                                      unsigned int buffer);
+
+vertex_array_cache_stats_t vertex_array_cache_get_stats(
+    const vertex_array_cache_t* cache);
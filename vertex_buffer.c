@@ -1,29 +1,83 @@
 #include "vertex_buffer.h"
 #include "renderer.h"
 vertex_buffer_t vertex_buffer_create(const void* data, unsigned int size) {
+  return vertex_buffer_create_with_usage(data, size, BUFFER_USAGE_STATIC);
+}
+
+vertex_buffer_t vertex_buffer_create_with_usage(const void* data,
+                                                unsigned int size,
+                                                buffer_usage_t usage) {
   vertex_buffer_t buffer;
 
-  GLCall(glGenBuffers(1, &buffer.m_renderer_id));
-  GLCall(glBindBuffer(GL_ARRAY_BUFFER, buffer.m_renderer_id));
-  GLCall(glBufferData(GL_ARRAY_BUFFER, size, data, GL_STATIC_DRAW));
+  buffer.m_renderer_id = gpu_buffer_create(data, size, size, usage);
+  buffer.m_size = data ? size : 0;
+  buffer.m_capacity = size;
+  buffer.m_usage = usage;
 
   return buffer;
 }
 
 void vertex_buffer_destroy(vertex_buffer_t* buffer) {
   if (buffer) {
-    GLCall(glDeleteBuffers(1, &buffer->m_renderer_id));
+    gpu_buffer_destroy(buffer->m_renderer_id);
     buffer->m_renderer_id = 0;  // Set to 0 to mark as deleted
+    buffer->m_size = 0;
+    buffer->m_capacity = 0;
   }
 }
 
 void vertex_buffer_bind(vertex_buffer_t* buffer) {
   if (buffer) {
-    GLCall(glBindBuffer(GL_ARRAY_BUFFER, buffer->m_renderer_id));
+    renderer_bind_buffer(GL_ARRAY_BUFFER, buffer->m_renderer_id);
   }
 }
 
 void vertex_buffer_unbind(void) {
   // Unbinding doesn't need the buffer pointer - just bind 0
-  GLCall(glBindBuffer(GL_ARRAY_BUFFER, 0));
-}
\ No newline at end of file
+  renderer_bind_buffer(GL_ARRAY_BUFFER, 0);
+}
+
+void vertex_buffer_reserve(vertex_buffer_t* buffer, unsigned int capacity) {
+  if (!buffer || capacity <= buffer->m_capacity) return;
+
+  capacity = gpu_buffer_grow_capacity(buffer->m_capacity, capacity);
+  gpu_buffer_resize(buffer->m_renderer_id, buffer->m_size, capacity,
+                    buffer->m_usage);
+  buffer->m_capacity = capacity;
+}
+
+void vertex_buffer_update(vertex_buffer_t* buffer, unsigned int offset,
+                          const void* data, unsigned int size) {
+  if (!buffer) return;
+
+  vertex_buffer_reserve(buffer, offset + size);
+  gpu_buffer_update(buffer->m_renderer_id, offset, data, size);
+
+  if (offset + size > buffer->m_size) buffer->m_size = offset + size;
+}
+
+void vertex_buffer_set_data(vertex_buffer_t* buffer, const void* data,
+                            unsigned int size) {
+  if (!buffer) return;
+
+  if (size > buffer->m_capacity) {
+    // Nothing to keep, so skip the copy a reserve would do
+    buffer->m_capacity = gpu_buffer_grow_capacity(buffer->m_capacity, size);
+    gpu_buffer_orphan(buffer->m_renderer_id, buffer->m_capacity,
+                      buffer->m_usage);
+  } else if (buffer->m_usage != BUFFER_USAGE_STATIC) {
+    gpu_buffer_orphan(buffer->m_renderer_id, buffer->m_capacity,
+                      buffer->m_usage);
+  }
+
+  gpu_buffer_update(buffer->m_renderer_id, 0, data, size);
+  buffer->m_size = size;
+}
+
+unsigned int vertex_buffer_get_size(const vertex_buffer_t* buffer) {
+  return buffer ? buffer->m_size : 0;
+}
+
+unsigned int vertex_buffer_get_capacity(const vertex_buffer_t* buffer) {
+  return buffer ? buffer->m_capacity : 0;
+}
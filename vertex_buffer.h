@@ -1,13 +1,29 @@
 #pragma once
+#include "gpu_buffer.h"
 
 typedef struct vertex_buffer {
   unsigned int m_renderer_id;
+  unsigned int m_size;      // Bytes of valid data
+  unsigned int m_capacity;  // Bytes allocated on the GPU
+  buffer_usage_t m_usage;
 } vertex_buffer_t;
 
 vertex_buffer_t vertex_buffer_create(const void* data, unsigned int size);
-
+vertex_buffer_t vertex_buffer_create_with_usage(const void* data,
+                                                unsigned int size,
+                                                buffer_usage_t usage);
 void vertex_buffer_destroy(vertex_buffer_t* buffer);
-
 void vertex_buffer_bind(vertex_buffer_t* buffer);
+void vertex_buffer_unbind(void);
+
+// Write size bytes at offset, growing the buffer if they do not fit
+void vertex_buffer_update(vertex_buffer_t* buffer, unsigned int offset,
+                          const void* data, unsigned int size);
+// Replace the whole contents, reusing the allocation when it is big enough
+void vertex_buffer_set_data(vertex_buffer_t* buffer, const void* data,
+                            unsigned int size);
+// Make room for at least capacity bytes, growing geometrically
+void vertex_buffer_reserve(vertex_buffer_t* buffer, unsigned int capacity);
 
-void vertex_buffer_unbind(void);
\ No newline at end of file
+unsigned int vertex_buffer_get_size(const vertex_buffer_t* buffer);
+unsigned int vertex_buffer_get_capacity(const vertex_buffer_t* buffer);
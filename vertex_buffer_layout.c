@@ -1,6 +1,7 @@
 #include "vertex_buffer_layout.h"
 #include <stdlib.h>
 #include <string.h>
+#include "hash.h"
 #include "renderer.h"
 
 #define INITIAL_CAPACITY \
@@ -14,6 +15,10 @@ vertex_buffer_layout_t vertex_buffer_layout_create(void) {
   layout.element_count = 0;
   layout.elements_capacity = INITIAL_CAPACITY;
   layout.stride = 0;
+  layout.locations = 0;
+  layout.divisor = 0;
+  layout.hash = 0;
+  layout.built = false;
 
   return layout;
 }
@@ -25,6 +30,10 @@ void vertex_buffer_layout_destroy(vertex_buffer_layout_t* layout) {
     layout->element_count = 0;
     layout->elements_capacity = 0;
     layout->stride = 0;
+    layout->locations = 0;
+    layout->divisor = 0;
+    layout->hash = 0;
+    layout->built = false;
   }
 }
 
@@ -37,35 +46,139 @@ static void ensure_capacity(vertex_buffer_layout_t* layout) {
   }
 }
 
+// size is the whole element's, since packed types hold several components
+// in one value
 static void push_element(vertex_buffer_layout_t* layout, unsigned int type,
                          unsigned int count, unsigned char normalized,
-                         unsigned int size_of_type) {
+                         unsigned int size) {
+  ASSERT(!layout->built);
+  if (layout->built) return;
+
   ensure_capacity(layout);
 
   vertex_buffer_element_t element;
   element.type = type;
   element.count = count;
   element.normalized = normalized;
-  element.size = count * size_of_type;
+  element.size = size;
+  element.locations = 1;
 
   layout->elements[layout->element_count] = element;
   layout->element_count++;
   layout->stride += element.size;
+  layout->locations += element.locations;
 }
 
 void vertex_buffer_layout_push_float(vertex_buffer_layout_t* layout,
                                      unsigned int count) {
-  push_element(layout, GL_FLOAT, count, GL_FALSE, sizeof(float));
+  push_element(layout, GL_FLOAT, count, GL_FALSE, count * sizeof(float));
 }
 
 void vertex_buffer_layout_push_uint(vertex_buffer_layout_t* layout,
                                     unsigned int count) {
-  push_element(layout, GL_UNSIGNED_INT, count, GL_FALSE, sizeof(unsigned int));
+  push_element(layout, GL_UNSIGNED_INT, count, GL_FALSE,
+               count * sizeof(unsigned int));
 }
 
 void vertex_buffer_layout_push_uchar(vertex_buffer_layout_t* layout,
                                      unsigned int count) {
-  push_element(layout, GL_UNSIGNED_BYTE, count, GL_TRUE, sizeof(unsigned char));
+  push_element(layout, GL_UNSIGNED_BYTE, count, GL_TRUE,
+               count * sizeof(unsigned char));
+}
+
+void vertex_buffer_layout_push_half(vertex_buffer_layout_t* layout,
+                                    unsigned int count) {
+  push_element(layout, GL_HALF_FLOAT, count, GL_FALSE,
+               count * sizeof(unsigned short));
+}
+
+void vertex_buffer_layout_push_short_norm(vertex_buffer_layout_t* layout,
+                                          unsigned int count) {
+  push_element(layout, GL_SHORT, count, GL_TRUE, count * sizeof(short));
+}
+
+void vertex_buffer_layout_push_ushort_norm(vertex_buffer_layout_t* layout,
+                                           unsigned int count) {
+  push_element(layout, GL_UNSIGNED_SHORT, count, GL_TRUE,
+               count * sizeof(unsigned short));
+}
+
+void vertex_buffer_layout_push_int_2_10_10_10(vertex_buffer_layout_t* layout) {
+  push_element(layout, GL_INT_2_10_10_10_REV, 4, GL_TRUE,
+               sizeof(unsigned int));
+}
+
+void vertex_buffer_layout_push_octahedral(vertex_buffer_layout_t* layout) {
+  push_element(layout, GL_SHORT, 2, GL_TRUE, 2 * sizeof(short));
+}
+
+void vertex_buffer_layout_push_mat4(vertex_buffer_layout_t* layout) {
+  push_element(layout, GL_FLOAT, 4, GL_FALSE, 16 * sizeof(float));
+  if (layout->built) return;
+
+  layout->elements[layout->element_count - 1].locations = 4;
+  layout->locations += 3;
+}
+
+void vertex_buffer_layout_set_divisor(vertex_buffer_layout_t* layout,
+                                      unsigned int divisor) {
+  ASSERT(!layout->built);
+  if (!layout->built) layout->divisor = divisor;
+}
+
+void vertex_buffer_layout_build(vertex_buffer_layout_t* layout) {
+  // Hash field by field, the element struct has padding
+  uint64_t hash = hash_bytes(&layout->stride, sizeof(layout->stride),
+                             HASH_SEED);
+  hash = hash_bytes(&layout->divisor, sizeof(layout->divisor), hash);
+  for (unsigned int i = 0; i < layout->element_count; i++) {
+    const vertex_buffer_element_t* element = &layout->elements[i];
+    hash = hash_bytes(&element->type, sizeof(element->type), hash);
+    hash = hash_bytes(&element->count, sizeof(element->count), hash);
+    hash = hash_bytes(&element->normalized, sizeof(element->normalized), hash);
+    hash = hash_bytes(&element->size, sizeof(element->size), hash);
+    hash = hash_bytes(&element->locations, sizeof(element->locations), hash);
+  }
+
+  layout->hash = hash;
+  layout->built = true;
+}
+
+bool vertex_buffer_layout_equal(const vertex_buffer_layout_t* a,
+                                const vertex_buffer_layout_t* b) {
+  if (a->hash != b->hash || a->stride != b->stride ||
+      a->divisor != b->divisor || a->element_count != b->element_count) {
+    return false;
+  }
+
+  // Field by field, the element struct has padding
+  for (unsigned int i = 0; i < a->element_count; i++) {
+    const vertex_buffer_element_t* x = &a->elements[i];
+    const vertex_buffer_element_t* y = &b->elements[i];
+    if (x->type != y->type || x->count != y->count ||
+        x->normalized != y->normalized || x->size != y->size ||
+        x->locations != y->locations) {
+      return false;
+    }
+  }
+  return true;
+}
+
+vertex_buffer_layout_t vertex_buffer_layout_copy(
+    const vertex_buffer_layout_t* layout) {
+  vertex_buffer_layout_t copy = *layout;
+  copy.elements_capacity =
+      layout->element_count > 0 ? layout->element_count : 1;
+  copy.elements = (vertex_buffer_element_t*)malloc(
+      copy.elements_capacity * sizeof(vertex_buffer_element_t));
+  memcpy(copy.elements, layout->elements,
+         layout->element_count * sizeof(vertex_buffer_element_t));
+  return copy;
+}
+
+uint64_t vertex_buffer_layout_get_hash(const vertex_buffer_layout_t* layout) {
+  ASSERT(layout->built);
+  return layout->hash;
 }
 
 unsigned int vertex_buffer_layout_get_stride(
@@ -81,6 +194,11 @@ vertex_buffer_element_t* vertex_buffer_layout_get_element(
   return NULL;
 }
 
+unsigned int vertex_buffer_layout_get_location_count(
+    const vertex_buffer_layout_t* layout) {
+  return layout ? layout->locations : 0;
+}
+
 unsigned int vertex_buffer_layout_get_element_count(
     const vertex_buffer_layout_t* layout) {
   return layout ? layout->element_count : 0;
@@ -1,17 +1,24 @@
 #pragma once
+#include <stdbool.h>
+#include <stdint.h>
 
 typedef struct vertex_buffer_element {
   unsigned int type;         // GL type (e.g., GL_FLOAT, GL_UNSIGNED_INT)
   unsigned int count;        // Number of components per vertex attribute
   unsigned char normalized;  // Whether to normalize
-  unsigned int size;         // Size in bytes of this type
+  unsigned int size;         // Size in bytes of the whole element
+  unsigned int locations;    // Attribute locations used, 4 for a mat4
 } vertex_buffer_element_t;
 
 typedef struct vertex_buffer_layout {
   vertex_buffer_element_t* elements;
   unsigned int element_count;
   unsigned int elements_capacity;
-  unsigned int stride;  // Sum of all element sizes
+  unsigned int stride;     // Sum of all element sizes
+  unsigned int locations;  // Sum of all element locations
+  unsigned int divisor;    // 0 per vertex, N to advance every N instances
+  uint64_t hash;           // Identifies the format once built
+  bool built;              // No more elements can be pushed
 } vertex_buffer_layout_t;
 
 vertex_buffer_layout_t vertex_buffer_layout_create(void);
@@ -27,11 +34,65 @@ void vertex_buffer_layout_push_uint(vertex_buffer_layout_t* layout,
 void vertex_buffer_layout_push_uchar(vertex_buffer_layout_t* layout,
                                      unsigned int count);
 
+// Compact formats, filled with the vertex_encode_* converters. Keep element
+// sizes a multiple of 4 bytes (e.g. 4 halves for a position) so attributes
+// stay aligned for fetch.
+
+// GL_HALF_FLOAT, 2 bytes per component
+void vertex_buffer_layout_push_half(vertex_buffer_layout_t* layout,
+                                    unsigned int count);
+
+// GL_SHORT normalized to [-1, 1], 2 bytes per component
+void vertex_buffer_layout_push_short_norm(vertex_buffer_layout_t* layout,
+                                          unsigned int count);
+
+// GL_UNSIGNED_SHORT normalized to [0, 1], 2 bytes per component
+void vertex_buffer_layout_push_ushort_norm(vertex_buffer_layout_t* layout,
+                                           unsigned int count);
+
+// GL_INT_2_10_10_10_REV normalized: xyzw packed into 4 bytes
+void vertex_buffer_layout_push_int_2_10_10_10(vertex_buffer_layout_t* layout);
+
+// Octahedral unit vector in two snorm16, 4 bytes. The shader sees a vec2
+// and decodes it with:
+//   vec3 n = vec3(e, 1.0 - abs(e.x) - abs(e.y));
+//   if (n.z < 0.0) n.xy = (1.0 - abs(n.yx)) * sign(n.xy);
+//   n = normalize(n);
+void vertex_buffer_layout_push_octahedral(vertex_buffer_layout_t* layout);
+
+// Column-major float matrix taking four consecutive attribute locations,
+// e.g. a per-instance model transform
+void vertex_buffer_layout_push_mat4(vertex_buffer_layout_t* layout);
+
+// Step rate of every attribute in the layout: 0 (the default) advances per
+// vertex, N > 0 advances once every N instances. Set before building.
+void vertex_buffer_layout_set_divisor(vertex_buffer_layout_t* layout,
+                                      unsigned int divisor);
+
+// Freeze the layout and compute its hash. Layouts with the same elements in
+// the same order hash equal, so they can share vertex arrays.
+void vertex_buffer_layout_build(vertex_buffer_layout_t* layout);
+
+uint64_t vertex_buffer_layout_get_hash(const vertex_buffer_layout_t* layout);
+
+// Whether two built layouts describe the same format, element by element.
+// Use after a hash match: equal hashes do not guarantee equal layouts.
+bool vertex_buffer_layout_equal(const vertex_buffer_layout_t* a,
+                                const vertex_buffer_layout_t* b);
+
+// Independent copy with its own element array, built if layout was
+vertex_buffer_layout_t vertex_buffer_layout_copy(
+    const vertex_buffer_layout_t* layout);
+
 unsigned int vertex_buffer_layout_get_stride(
     const vertex_buffer_layout_t* layout);
 
 vertex_buffer_element_t* vertex_buffer_layout_get_element(
     const vertex_buffer_layout_t* layout, unsigned int index);
 
+// Attribute locations the layout needs, at least one per element
+unsigned int vertex_buffer_layout_get_location_count(
+    const vertex_buffer_layout_t* layout);
+
 unsigned int vertex_buffer_layout_get_element_count(
     const vertex_buffer_layout_t* layout);
\ No newline at end of file
@@ -0,0 +1,273 @@
+#include "vertex_encode.h"
+#include <math.h>
+#include <string.h>
+
+#if defined(__SSE2__) || defined(_M_X64) || \
+    (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define VERTEX_ENCODE_SSE2 1
+#elif (defined(__ARM_NEON) && defined(__aarch64__)) || defined(_M_ARM64)
+// AArch64 only: vcvtnq_s32_f32 and an always-available vcvt_f16_f32 are
+// not part of 32-bit NEON, which takes the scalar paths
+#include <arm_neon.h>
+#define VERTEX_ENCODE_NEON 1
+#endif
+
+static float clampf(float value, float low, float high) {
+  return value < low ? low : (value > high ? high : value);
+}
+
+// Round half away from zero, matching what the SIMD paths produce for
+// in-range values closely enough (they round half to even)
+static int round_to_int(float value) {
+  return (int)(value < 0.0f ? value - 0.5f : value + 0.5f);
+}
+
+// Fabian Giesen's float_to_half_fast3_rtne
+static unsigned short float_to_half(float value) {
+  unsigned int bits;
+  memcpy(&bits, &value, sizeof(bits));
+
+  unsigned int sign = bits & 0x80000000u;
+  bits ^= sign;
+
+  unsigned int half;
+  if (bits >= 0x47800000u) {
+    // Too large for a half: infinity, or a quiet NaN
+    half = bits > 0x7F800000u ? 0x7E00u : 0x7C00u;
+  } else if (bits < 0x38800000u) {
+    // Subnormal or zero: let the FPU align the mantissa by adding 0.5
+    const unsigned int magic_bits = 126u << 23;
+    float magic, sum;
+    memcpy(&magic, &magic_bits, sizeof(magic));
+    memcpy(&sum, &bits, sizeof(sum));
+    sum += magic;
+    memcpy(&half, &sum, sizeof(half));
+    half -= magic_bits;
+  } else {
+    unsigned int mantissa_odd = (bits >> 13) & 1;
+    bits += ((unsigned int)(15 - 127) << 23) + 0xFFFu;
+    bits += mantissa_odd;
+    half = bits >> 13;
+  }
+  return (unsigned short)(half | (sign >> 16));
+}
+
+void vertex_encode_half(unsigned short* dst, const float* src, size_t count) {
+  size_t i = 0;
+
+#if defined(VERTEX_ENCODE_SSE2)
+  // The scalar conversion, four lanes at a time with masks for the cases
+  const __m128i sign_mask = _mm_set1_epi32((int)0x80000000u);
+  const __m128i f16_max = _mm_set1_epi32(0x47800000);
+  const __m128i f32_infinity = _mm_set1_epi32(0x7F800000);
+  const __m128i min_normal = _mm_set1_epi32(0x38800000);
+  const __m128i subnormal_magic = _mm_set1_epi32(126 << 23);
+  const __m128i normal_bias = _mm_set1_epi32((int)(0xFFFu - (112u << 23)));
+  const __m128i nan_bit = _mm_set1_epi32(0x200);
+  const __m128i f16_infinity = _mm_set1_epi32(0x7C00);
+
+  for (; i + 8 <= count; i += 8) {
+    __m128i halves[2];
+    for (int half = 0; half < 2; half++) {
+      __m128i bits = _mm_castps_si128(_mm_loadu_ps(src + i + half * 4));
+      __m128i sign = _mm_and_si128(bits, sign_mask);
+      __m128i abs = _mm_xor_si128(bits, sign);
+
+      __m128i is_nan = _mm_cmpgt_epi32(abs, f32_infinity);
+      __m128i is_regular = _mm_cmpgt_epi32(f16_max, abs);
+      __m128i is_subnormal = _mm_cmpgt_epi32(min_normal, abs);
+      __m128i inf_or_nan =
+          _mm_or_si128(_mm_and_si128(is_nan, nan_bit), f16_infinity);
+
+      __m128 subnormal_sum = _mm_add_ps(_mm_castsi128_ps(abs),
+                                        _mm_castsi128_ps(subnormal_magic));
+      __m128i subnormal =
+          _mm_sub_epi32(_mm_castps_si128(subnormal_sum), subnormal_magic);
+
+      __m128i mantissa_odd = _mm_srai_epi32(_mm_slli_epi32(abs, 31 - 13), 31);
+      __m128i normal = _mm_srli_epi32(
+          _mm_sub_epi32(_mm_add_epi32(abs, normal_bias), mantissa_odd), 13);
+
+      __m128i finite = _mm_or_si128(_mm_and_si128(is_subnormal, subnormal),
+                                    _mm_andnot_si128(is_subnormal, normal));
+      __m128i joined = _mm_or_si128(_mm_and_si128(is_regular, finite),
+                                    _mm_andnot_si128(is_regular, inf_or_nan));
+      // Arithmetic shift leaves the upper half all ones for negative
+      // values, which keeps the signed saturating pack below exact
+      halves[half] = _mm_or_si128(joined, _mm_srai_epi32(sign, 16));
+    }
+    _mm_storeu_si128((__m128i*)(dst + i),
+                     _mm_packs_epi32(halves[0], halves[1]));
+  }
+#elif defined(VERTEX_ENCODE_NEON)
+  for (; i + 4 <= count; i += 4) {
+    float16x4_t halves = vcvt_f16_f32(vld1q_f32(src + i));
+    vst1_u16(dst + i, vreinterpret_u16_f16(halves));
+  }
+#endif
+
+  for (; i < count; i++) dst[i] = float_to_half(src[i]);
+}
+
+void vertex_encode_snorm16(short* dst, const float* src, size_t count) {
+  size_t i = 0;
+
+#if defined(VERTEX_ENCODE_SSE2)
+  const __m128 low = _mm_set1_ps(-1.0f), high = _mm_set1_ps(1.0f);
+  const __m128 scale = _mm_set1_ps(32767.0f);
+  for (; i + 8 <= count; i += 8) {
+    __m128 a = _mm_min_ps(_mm_max_ps(_mm_loadu_ps(src + i), low), high);
+    __m128 b = _mm_min_ps(_mm_max_ps(_mm_loadu_ps(src + i + 4), low), high);
+    __m128i ia = _mm_cvtps_epi32(_mm_mul_ps(a, scale));
+    __m128i ib = _mm_cvtps_epi32(_mm_mul_ps(b, scale));
+    _mm_storeu_si128((__m128i*)(dst + i), _mm_packs_epi32(ia, ib));
+  }
+#elif defined(VERTEX_ENCODE_NEON)
+  const float32x4_t low = vdupq_n_f32(-1.0f), high = vdupq_n_f32(1.0f);
+  for (; i + 4 <= count; i += 4) {
+    float32x4_t v = vminq_f32(vmaxq_f32(vld1q_f32(src + i), low), high);
+    int32x4_t iv = vcvtnq_s32_f32(vmulq_n_f32(v, 32767.0f));
+    vst1_s16(dst + i, vqmovn_s32(iv));
+  }
+#endif
+
+  for (; i < count; i++) {
+    dst[i] = (short)round_to_int(clampf(src[i], -1.0f, 1.0f) * 32767.0f);
+  }
+}
+
+void vertex_encode_unorm16(unsigned short* dst, const float* src,
+                           size_t count) {
+  size_t i = 0;
+
+#if defined(VERTEX_ENCODE_SSE2)
+  // SSE2 can only pack with signed saturation, so pack the values biased
+  // by -32768 and flip the top bit back
+  const __m128 low = _mm_set1_ps(0.0f), high = _mm_set1_ps(1.0f);
+  const __m128 scale = _mm_set1_ps(65535.0f);
+  const __m128i bias = _mm_set1_epi32(32768);
+  const __m128i flip = _mm_set1_epi16((short)0x8000);
+  for (; i + 8 <= count; i += 8) {
+    __m128 a = _mm_min_ps(_mm_max_ps(_mm_loadu_ps(src + i), low), high);
+    __m128 b = _mm_min_ps(_mm_max_ps(_mm_loadu_ps(src + i + 4), low), high);
+    __m128i ia = _mm_sub_epi32(_mm_cvtps_epi32(_mm_mul_ps(a, scale)), bias);
+    __m128i ib = _mm_sub_epi32(_mm_cvtps_epi32(_mm_mul_ps(b, scale)), bias);
+    _mm_storeu_si128((__m128i*)(dst + i),
+                     _mm_xor_si128(_mm_packs_epi32(ia, ib), flip));
+  }
+#elif defined(VERTEX_ENCODE_NEON)
+  const float32x4_t low = vdupq_n_f32(0.0f), high = vdupq_n_f32(1.0f);
+  for (; i + 4 <= count; i += 4) {
+    float32x4_t v = vminq_f32(vmaxq_f32(vld1q_f32(src + i), low), high);
+    int32x4_t iv = vcvtnq_s32_f32(vmulq_n_f32(v, 65535.0f));
+    vst1_u16(dst + i, vqmovun_s32(iv));
+  }
+#endif
+
+  for (; i < count; i++) {
+    dst[i] = (unsigned short)round_to_int(clampf(src[i], 0.0f, 1.0f) *
+                                          65535.0f);
+  }
+}
+
+void vertex_encode_int_2_10_10_10(unsigned int* dst, const float* src,
+                                  size_t count) {
+  size_t i = 0;
+
+#if defined(VERTEX_ENCODE_SSE2)
+  // Four vectors at a time, transposed so each register holds one
+  // component; w's upper bits shift out of the word
+  const __m128 low = _mm_set1_ps(-1.0f), high = _mm_set1_ps(1.0f);
+  const __m128 scale = _mm_set1_ps(511.0f);
+  const __m128i mask = _mm_set1_epi32(0x3FF);
+  for (; i + 4 <= count; i += 4) {
+    __m128 x = _mm_min_ps(_mm_max_ps(_mm_loadu_ps(src + i * 4), low), high);
+    __m128 y =
+        _mm_min_ps(_mm_max_ps(_mm_loadu_ps(src + i * 4 + 4), low), high);
+    __m128 z =
+        _mm_min_ps(_mm_max_ps(_mm_loadu_ps(src + i * 4 + 8), low), high);
+    __m128 w =
+        _mm_min_ps(_mm_max_ps(_mm_loadu_ps(src + i * 4 + 12), low), high);
+    _MM_TRANSPOSE4_PS(x, y, z, w);
+
+    __m128i ix = _mm_and_si128(_mm_cvtps_epi32(_mm_mul_ps(x, scale)), mask);
+    __m128i iy = _mm_and_si128(_mm_cvtps_epi32(_mm_mul_ps(y, scale)), mask);
+    __m128i iz = _mm_and_si128(_mm_cvtps_epi32(_mm_mul_ps(z, scale)), mask);
+    __m128i iw = _mm_cvtps_epi32(w);
+    __m128i packed =
+        _mm_or_si128(_mm_or_si128(ix, _mm_slli_epi32(iy, 10)),
+                     _mm_or_si128(_mm_slli_epi32(iz, 20),
+                                  _mm_slli_epi32(iw, 30)));
+    _mm_storeu_si128((__m128i*)(dst + i), packed);
+  }
+#elif defined(VERTEX_ENCODE_NEON)
+  const float32x4_t low = vdupq_n_f32(-1.0f), high = vdupq_n_f32(1.0f);
+  const uint32x4_t mask = vdupq_n_u32(0x3FF);
+  for (; i + 4 <= count; i += 4) {
+    float32x4x4_t v = vld4q_f32(src + i * 4);  // De-interleaved to x, y, z, w
+    uint32x4_t ix = vandq_u32(
+        vreinterpretq_u32_s32(vcvtnq_s32_f32(vmulq_n_f32(
+            vminq_f32(vmaxq_f32(v.val[0], low), high), 511.0f))),
+        mask);
+    uint32x4_t iy = vandq_u32(
+        vreinterpretq_u32_s32(vcvtnq_s32_f32(vmulq_n_f32(
+            vminq_f32(vmaxq_f32(v.val[1], low), high), 511.0f))),
+        mask);
+    uint32x4_t iz = vandq_u32(
+        vreinterpretq_u32_s32(vcvtnq_s32_f32(vmulq_n_f32(
+            vminq_f32(vmaxq_f32(v.val[2], low), high), 511.0f))),
+        mask);
+    uint32x4_t iw = vreinterpretq_u32_s32(
+        vcvtnq_s32_f32(vminq_f32(vmaxq_f32(v.val[3], low), high)));
+    uint32x4_t packed =
+        vorrq_u32(vorrq_u32(ix, vshlq_n_u32(iy, 10)),
+                  vorrq_u32(vshlq_n_u32(iz, 20), vshlq_n_u32(iw, 30)));
+    vst1q_u32(dst + i, packed);
+  }
+#endif
+
+  for (; i < count; i++) {
+    const float* v = src + i * 4;
+    unsigned int x = (unsigned int)round_to_int(clampf(v[0], -1.0f, 1.0f) *
+                                                511.0f);
+    unsigned int y = (unsigned int)round_to_int(clampf(v[1], -1.0f, 1.0f) *
+                                                511.0f);
+    unsigned int z = (unsigned int)round_to_int(clampf(v[2], -1.0f, 1.0f) *
+                                                511.0f);
+    unsigned int w = (unsigned int)round_to_int(clampf(v[3], -1.0f, 1.0f));
+    dst[i] = (x & 0x3FFu) | ((y & 0x3FFu) << 10) | ((z & 0x3FFu) << 20) |
+             ((w & 0x3u) << 30);
+  }
+}
+
+void vertex_encode_octahedral(short* dst, const float* src, size_t count) {
+  // Project onto the octahedron |x| + |y| + |z| = 1 and fold the lower
+  // half over the diagonals, into a scratch block that is then quantized
+  // in bulk
+  float projected[256];
+  size_t done = 0;
+
+  while (done < count) {
+    size_t batch = count - done;
+    if (batch > 128) batch = 128;
+
+    for (size_t i = 0; i < batch; i++) {
+      const float* n = src + (done + i) * 3;
+      float length = fabsf(n[0]) + fabsf(n[1]) + fabsf(n[2]);
+      float x = length > 0.0f ? n[0] / length : 0.0f;
+      float y = length > 0.0f ? n[1] / length : 0.0f;
+      if (n[2] < 0.0f) {
+        float folded_x = (1.0f - fabsf(y)) * (x >= 0.0f ? 1.0f : -1.0f);
+        float folded_y = (1.0f - fabsf(x)) * (y >= 0.0f ? 1.0f : -1.0f);
+        x = folded_x;
+        y = folded_y;
+      }
+      projected[i * 2] = x;
+      projected[i * 2 + 1] = y;
+    }
+
+    vertex_encode_snorm16(dst + done * 2, projected, batch * 2);
+    done += batch;
+  }
+}
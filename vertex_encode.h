@@ -0,0 +1,29 @@
+#pragma once
+#include <stddef.h>
+
+// CPU-side converters from float attribute data to the compact formats
+// vertex_buffer_layout can describe. Each one reads count contiguous input
+// values (or vectors, where noted) and writes them contiguously; interleave
+// the results into the vertex buffer according to the layout. Out-of-range
+// inputs are clamped.
+
+// IEEE half floats for vertex_buffer_layout_push_half, round to nearest
+// even. Keeps ~3 significant digits, so positions should be local to the
+// mesh (or use snorm16 with a scale and bias).
+void vertex_encode_half(unsigned short* dst, const float* src, size_t count);
+
+// [-1, 1] to 16-bit signed normalized, for push_short_norm
+void vertex_encode_snorm16(short* dst, const float* src, size_t count);
+
+// [0, 1] to 16-bit unsigned normalized, for push_ushort_norm
+void vertex_encode_unorm16(unsigned short* dst, const float* src,
+                           size_t count);
+
+// count xyzw vectors in [-1, 1] to GL_INT_2_10_10_10_REV, for
+// push_int_2_10_10_10. w only keeps -1, 0 or 1 (e.g. tangent handedness).
+void vertex_encode_int_2_10_10_10(unsigned int* dst, const float* src,
+                                  size_t count);
+
+// count unit xyz normals to octahedral coordinates, two snorm16 per normal,
+// for push_octahedral. Angular error stays below 0.01 degrees.
+void vertex_encode_octahedral(short* dst, const float* src, size_t count);